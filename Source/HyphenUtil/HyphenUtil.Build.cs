@@ -38,6 +38,8 @@ public class HyphenUtil : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"EngineSettings",
+				"Json",
 				"Slate",
 				"SlateCore",
 				"Settings"
@@ -0,0 +1,226 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenActorPoolSubsystem.h"
+
+#include "HyphenSpawnSubsystem.h"
+#include "HyphenUtilLogs.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+UHyphenActorPoolSubsystem* UHyphenActorPoolSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	return World ? World->GetSubsystem<UHyphenActorPoolSubsystem>() : nullptr;
+}
+
+void UHyphenActorPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	ReferenceTagReleasedHandle = UHyphenAssetManager::GetReferenceTagReleased().AddUObject(this, &UHyphenActorPoolSubsystem::OnReferenceTagReleased);
+}
+
+void UHyphenActorPoolSubsystem::Deinitialize()
+{
+	if (UHyphenAssetManager* AssetManager = Cast<UHyphenAssetManager>(GEngine ? GEngine->AssetManager : nullptr))
+	{
+		AssetManager->GetReferenceTagReleased().Remove(ReferenceTagReleasedHandle);
+	}
+	ReferenceTagReleasedHandle.Reset();
+	// Pooled actors are destroyed with the world
+	FreeLists.Empty();
+	Super::Deinitialize();
+}
+
+AActor* UHyphenActorPoolSubsystem::AcquireActor(TSubclassOf<AActor> ActorClass, const FTransform& Transform)
+{
+	if (!ActorClass)
+	{
+		return nullptr;
+	}
+
+	FHyphenActorFreeList& FreeList = FindOrAddFreeList(ActorClass, NAME_None);
+	while (FreeList.Actors.Num() > 0)
+	{
+		// The component state goes with the slot, also when GC already cleared its actor
+		const FHyphenPooledActor PooledActor = FreeList.Actors.Pop(false);
+		if (IsValid(PooledActor.Actor))
+		{
+			ActivateActor(PooledActor, Transform);
+			return PooledActor.Actor;
+		}
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(ActorClass, Transform, SpawnParameters);
+	if (Actor && Actor->Implements<UHyphenPoolableActor>())
+	{
+		IHyphenPoolableActor::Execute_OnPoolActivated(Actor);
+	}
+	return Actor;
+}
+
+void UHyphenActorPoolSubsystem::ReleaseActor(AActor* Actor)
+{
+	PoolActor(Actor, true);
+}
+
+TSharedPtr<FHyphenSpawnBatch> UHyphenActorPoolSubsystem::PrewarmActors(const TSoftClassPtr<AActor>& ActorClass, int32 Count, FName ReferenceAssetTag)
+{
+	UHyphenSpawnSubsystem* SpawnSubsystem = UHyphenSpawnSubsystem::Get(this);
+	if (SpawnSubsystem == nullptr || ActorClass.IsNull() || Count <= 0)
+	{
+		return nullptr;
+	}
+
+	TArray<FHyphenSpawnRequest> Requests;
+	Requests.Init(FHyphenSpawnRequest{ActorClass, FTransform::Identity}, Count);
+	TSharedRef<FHyphenSpawnBatch> Batch = SpawnSubsystem->SpawnActorsAsync(Requests, ReferenceAssetTag);
+	Batch->OnActorSpawned.AddWeakLambda(this, [this, ReferenceAssetTag](AActor* Actor)
+	{
+		FindOrAddFreeList(Actor->GetClass(), ReferenceAssetTag);
+		PoolActor(Actor, false);
+	});
+	return Batch;
+}
+
+void UHyphenActorPoolSubsystem::DrainPool(TSubclassOf<AActor> ActorClass)
+{
+	FHyphenActorFreeList FreeList;
+	if (!FreeLists.RemoveAndCopyValue(ActorClass, FreeList))
+	{
+		return;
+	}
+	for (const FHyphenPooledActor& PooledActor : FreeList.Actors)
+	{
+		if (IsValid(PooledActor.Actor))
+		{
+			PooledActor.Actor->Destroy();
+		}
+	}
+	UE_LOG(LogHyphenUtil, Log, TEXT("Drained actor pool of [%s]: %d actors"), *GetNameSafe(ActorClass), FreeList.Actors.Num());
+}
+
+int32 UHyphenActorPoolSubsystem::GetNumPooledActors(TSubclassOf<AActor> ActorClass) const
+{
+	const FHyphenActorFreeList* FreeList = FreeLists.Find(ActorClass);
+	return FreeList ? FreeList->Actors.Num() : 0;
+}
+
+FHyphenActorFreeList& UHyphenActorPoolSubsystem::FindOrAddFreeList(TSubclassOf<AActor> ActorClass, FName ReferenceAssetTag)
+{
+	FHyphenActorFreeList& FreeList = FreeLists.FindOrAdd(ActorClass);
+	if (FreeList.ReferenceAssetTag == NAME_None)
+	{
+		FreeList.ReferenceAssetTag = ReferenceAssetTag;
+	}
+	return FreeList;
+}
+
+void UHyphenActorPoolSubsystem::PoolActor(AActor* Actor, bool bWasActivated)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	FHyphenActorFreeList* FreeList = FreeLists.Find(Actor->GetClass());
+	if (FreeList == nullptr || FreeList->Actors.Num() >= MaxPooledActorsPerClass)
+	{
+		Actor->Destroy();
+		return;
+	}
+	if (!ensureMsgf(!FreeList->Actors.ContainsByPredicate([Actor](const FHyphenPooledActor& PooledActor) { return PooledActor.Actor == Actor; }),
+	                TEXT("Actor [%s] was released to its pool twice"), *Actor->GetName()))
+	{
+		return;
+	}
+	FHyphenPooledActor PooledActor;
+	PooledActor.Actor = Actor;
+	DeactivateActor(PooledActor, bWasActivated);
+	// The deactivate hook may have pooled other actors or drained the pool, find the free list again
+	FreeList = FreeLists.Find(Actor->GetClass());
+	if (FreeList == nullptr)
+	{
+		Actor->Destroy();
+		return;
+	}
+	FreeList->Actors.Add(MoveTemp(PooledActor));
+}
+
+void UHyphenActorPoolSubsystem::ActivateActor(const FHyphenPooledActor& PooledActor, const FTransform& Transform)
+{
+	AActor* Actor = PooledActor.Actor;
+	Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Actor->SetActorHiddenInGame(false);
+	Actor->SetActorEnableCollision(true);
+	Actor->SetActorTickEnabled(true);
+	for (const TWeakObjectPtr<UPrimitiveComponent>& Component : PooledActor.SimulatingComponents)
+	{
+		if (UPrimitiveComponent* Primitive = Component.Get())
+		{
+			Primitive->SetSimulatePhysics(true);
+		}
+	}
+	for (const TWeakObjectPtr<UActorComponent>& Component : PooledActor.TickingComponents)
+	{
+		if (UActorComponent* TickingComponent = Component.Get())
+		{
+			TickingComponent->SetComponentTickEnabled(true);
+		}
+	}
+	if (Actor->Implements<UHyphenPoolableActor>())
+	{
+		IHyphenPoolableActor::Execute_OnPoolActivated(Actor);
+	}
+}
+
+void UHyphenActorPoolSubsystem::DeactivateActor(FHyphenPooledActor& PooledActor, bool bWasActivated)
+{
+	AActor* Actor = PooledActor.Actor;
+	if (bWasActivated && Actor->Implements<UHyphenPoolableActor>())
+	{
+		IHyphenPoolableActor::Execute_OnPoolDeactivated(Actor);
+	}
+	Actor->SetActorTickEnabled(false);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorHiddenInGame(true);
+
+	// Actor tick and collision do not cover components, movement components and simulated bodies would keep going
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (Component == nullptr)
+		{
+			continue;
+		}
+		if (Component->IsComponentTickEnabled())
+		{
+			Component->SetComponentTickEnabled(false);
+			PooledActor.TickingComponents.Add(Component);
+		}
+		UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+		if (Primitive && Primitive->IsSimulatingPhysics())
+		{
+			Primitive->SetSimulatePhysics(false);
+			PooledActor.SimulatingComponents.Add(Primitive);
+		}
+	}
+}
+
+void UHyphenActorPoolSubsystem::OnReferenceTagReleased(FName ReferenceAssetTag)
+{
+	TArray<TSubclassOf<AActor>> DrainedClasses;
+	for (const auto& FreeListPair : FreeLists)
+	{
+		if (FreeListPair.Value.ReferenceAssetTag == ReferenceAssetTag)
+		{
+			DrainedClasses.Add(FreeListPair.Key);
+		}
+	}
+	for (const TSubclassOf<AActor> DrainedClass : DrainedClasses)
+	{
+		DrainPool(DrainedClass);
+	}
+}
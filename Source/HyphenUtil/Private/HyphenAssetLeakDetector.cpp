@@ -0,0 +1,211 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#include "HyphenAssetLeakDetector.h"
+
+#include "HyphenUtilLogs.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/FileManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectArray.h"
+
+namespace HyphenAssetLeakDetector
+{
+	// Reverse reference graph in compressed rows, Referencers[Offsets[i] .. Offsets[i + 1]) reference object index i.
+	struct FReferencerGraph
+	{
+		TArray<int32> Offsets;
+		TArray<int32> Referencers;
+
+		TArrayView<const int32> GetReferencers(int32 ObjectIndex) const
+		{
+			return MakeArrayView(Referencers.GetData() + Offsets[ObjectIndex], Offsets[ObjectIndex + 1] - Offsets[ObjectIndex]);
+		}
+	};
+
+	UObject* GetLiveObject(int32 ObjectIndex)
+	{
+		const FUObjectItem* ObjectItem = GUObjectArray.IndexToObject(ObjectIndex);
+		if (ObjectItem == nullptr || ObjectItem->Object == nullptr || ObjectItem->IsUnreachable())
+		{
+			return nullptr;
+		}
+		return static_cast<UObject*>(ObjectItem->Object);
+	}
+
+	bool IsRoot(int32 ObjectIndex)
+	{
+		const FUObjectItem* ObjectItem = GUObjectArray.IndexToObject(ObjectIndex);
+		return ObjectItem->IsRootSet() || GUObjectArray.IsDisregardForGC(static_cast<UObject*>(ObjectItem->Object));
+	}
+
+	FReferencerGraph BuildReferencerGraph()
+	{
+		const int32 NumObjects = GUObjectArray.GetObjectArrayNum();
+
+		// Edges as (referenced, referencer). Serializing objects for references is not thread safe, so this stays on the game thread.
+		TArray<TPair<int32, int32>> Edges;
+		TArray<UObject*> ReferencedObjects;
+		for (int32 ObjectIndex = 0; ObjectIndex < NumObjects; ObjectIndex++)
+		{
+			UObject* Object = GetLiveObject(ObjectIndex);
+			if (Object == nullptr)
+			{
+				continue;
+			}
+			ReferencedObjects.Reset();
+			//no outer, ignore archetype, direct references only, keep transient
+			FReferenceFinder ObjectReferenceCollector(ReferencedObjects, nullptr, false, true, false, false);
+			ObjectReferenceCollector.FindReferences(Object);
+			for (const UObject* ReferencedObject : ReferencedObjects)
+			{
+				if (ReferencedObject && ReferencedObject != Object)
+				{
+					Edges.Emplace(GUObjectArray.ObjectToIndex(ReferencedObject), ObjectIndex);
+				}
+			}
+		}
+
+		FReferencerGraph Graph;
+		Graph.Offsets.SetNumZeroed(NumObjects + 1);
+		for (const TPair<int32, int32>& Edge : Edges)
+		{
+			Graph.Offsets[Edge.Key + 1]++;
+		}
+		for (int32 i = 0; i < NumObjects; i++)
+		{
+			Graph.Offsets[i + 1] += Graph.Offsets[i];
+		}
+		Graph.Referencers.SetNumUninitialized(Edges.Num());
+		TArray<int32> Cursor(Graph.Offsets.GetData(), NumObjects);
+		for (const TPair<int32, int32>& Edge : Edges)
+		{
+			Graph.Referencers[Cursor[Edge.Key]++] = Edge.Value;
+		}
+		return Graph;
+	}
+
+	// Breadth first search towards referencers, returns the chain from the survivor to the first root found.
+	TArray<int32> FindShortestReferencerChain(const FReferencerGraph& Graph, int32 SurvivorIndex)
+	{
+		TMap<int32, int32> ReachedFrom;
+		TArray<int32> Frontier;
+		ReachedFrom.Add(SurvivorIndex, INDEX_NONE);
+		Frontier.Add(SurvivorIndex);
+
+		int32 ChainEnd = INDEX_NONE;
+		for (int32 Head = 0; Head < Frontier.Num() && ChainEnd == INDEX_NONE; Head++)
+		{
+			const int32 ObjectIndex = Frontier[Head];
+			if (ObjectIndex != SurvivorIndex && IsRoot(ObjectIndex))
+			{
+				ChainEnd = ObjectIndex;
+				break;
+			}
+			for (const int32 ReferencerIndex : Graph.GetReferencers(ObjectIndex))
+			{
+				if (!ReachedFrom.Contains(ReferencerIndex))
+				{
+					ReachedFrom.Add(ReferencerIndex, ObjectIndex);
+					Frontier.Add(ReferencerIndex);
+				}
+			}
+		}
+
+		TArray<int32> Chain;
+		if (ChainEnd == INDEX_NONE)
+		{
+			// Nothing reachable is rooted, the survivor is kept by a native referencer (FGCObject) at the end of the search
+			Chain.Add(SurvivorIndex);
+			return Chain;
+		}
+		for (int32 ObjectIndex = ChainEnd; ObjectIndex != INDEX_NONE; ObjectIndex = ReachedFrom[ObjectIndex])
+		{
+			Chain.Insert(ObjectIndex, 0);
+		}
+		return Chain;
+	}
+
+	FString DescribeChain(const TArray<int32>& Chain)
+	{
+		FString Description;
+		for (int32 i = 0; i < Chain.Num(); i++)
+		{
+			const UObject* Object = GetLiveObject(Chain[i]);
+			Description += FString::Printf(TEXT("%s%s %s\n"), i == 0 ? TEXT("  ") : TEXT("    <- "),
+			                               *GetNameSafe(Object ? Object->GetClass() : nullptr), *GetPathNameSafe(Object));
+		}
+		if (Chain.Num() == 1)
+		{
+			Description += TEXT("    <- (no rooted UObject referencer, held by a native FGCObject or AddReferencedObjects)\n");
+		}
+		else
+		{
+			Description += TEXT("    (root)\n");
+		}
+		return Description;
+	}
+}
+
+int32 HyphenUtil::DetectAssetLeaks(const TArray<FWeakObjectPtr>& ReleasedObjects, const TSet<FObjectKey>& IgnoredObjects)
+{
+	using namespace HyphenAssetLeakDetector;
+	check(IsInGameThread() && !IsGarbageCollecting());
+	LLM_SCOPE_BYTAG(HyphenUtil);
+
+	TArray<int32> Survivors;
+	for (const FWeakObjectPtr& ReleasedObject : ReleasedObjects)
+	{
+		if (const UObject* Object = ReleasedObject.Get())
+		{
+			if (!IgnoredObjects.Contains(Object))
+			{
+				Survivors.AddUnique(GUObjectArray.ObjectToIndex(Object));
+			}
+		}
+	}
+	UE_LOG(LogHyphenUtil, Display, TEXT("Asset leak detection: %d of %d released objects survived GC"), Survivors.Num(), ReleasedObjects.Num());
+	if (Survivors.Num() == 0)
+	{
+		return 0;
+	}
+
+	const FString ReportPath = FPaths::ProjectLogDir() / FString::Printf(TEXT("HyphenAssetLeaks-%s.txt"), *FDateTime::Now().ToString());
+	TUniquePtr<FArchive> Report(IFileManager::Get().CreateFileWriter(*ReportPath));
+	auto WriteReport = [&Report](const FString& Text)
+	{
+		if (Report)
+		{
+			FTCHARToUTF8 Utf8Text(*Text);
+			Report->Serialize(const_cast<ANSICHAR*>(Utf8Text.Get()), Utf8Text.Length());
+			Report->Flush();
+		}
+	};
+	WriteReport(FString::Printf(TEXT("%d leaked objects\n\n"), Survivors.Num()));
+
+	const FReferencerGraph Graph = BuildReferencerGraph();
+
+	// Search in parallel batches and write each batch out before starting the next one
+	const int32 BatchSize = FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+	for (int32 BatchStart = 0; BatchStart < Survivors.Num(); BatchStart += BatchSize)
+	{
+		const int32 BatchNum = FMath::Min(BatchSize, Survivors.Num() - BatchStart);
+		TArray<TArray<int32>> Chains;
+		Chains.SetNum(BatchNum);
+		ParallelFor(BatchNum, [&](int32 i)
+		{
+			Chains[i] = FindShortestReferencerChain(Graph, Survivors[BatchStart + i]);
+		});
+
+		for (const TArray<int32>& Chain : Chains)
+		{
+			const FString Description = DescribeChain(Chain);
+			UE_LOG(LogHyphenUtil, Warning, TEXT("Leaked asset:\n%s"), *Description);
+			WriteReport(Description + TEXT("\n"));
+		}
+	}
+
+	UE_LOG(LogHyphenUtil, Display, TEXT("Asset leak report written to %s"), *ReportPath);
+	return Survivors.Num();
+}
@@ -3,13 +3,159 @@
 
 #include "HyphenAssetManager.h"
 
+#include "GameMapsSettings.h"
+#include "HyphenAssetLeakDetector.h"
 #include "HyphenUtilLibrary.h"
 #include "HyphenUtilLogs.h"
+#include "Async/Async.h"
+#include "Engine/Engine.h"
+#include "Misc/CoreDelegates.h"
+
+FHyphenWarmUpProgress UHyphenAssetManager::WarmUpProgress;
+
+namespace HyphenAssetManager
+{
+	/**
+	 * Fixed-capacity open addressing table of tag progress records.
+	 * Only the game thread inserts, readers on any thread probe with acquire loads. Records are never removed.
+	 */
+	struct FTagLoadProgressTable
+	{
+		static constexpr int32 Capacity = 4096;
+		static constexpr int32 MaxRecords = Capacity * 3 / 4;
+
+		std::atomic<FHyphenTagLoadProgress*> Slots[Capacity] = {};
+		TArray<TUniquePtr<FHyphenTagLoadProgress>> Records;
+
+		FHyphenTagLoadProgress* Find(FName AssetTag) const
+		{
+			for (uint32 Index = GetTypeHash(AssetTag) & (Capacity - 1);; Index = (Index + 1) & (Capacity - 1))
+			{
+				FHyphenTagLoadProgress* Record = Slots[Index].load(std::memory_order_acquire);
+				if (Record == nullptr || Record->AssetTag == AssetTag)
+				{
+					return Record;
+				}
+			}
+		}
+
+		FHyphenTagLoadProgress* FindOrAdd(FName AssetTag)
+		{
+			check(IsInGameThread());
+			uint32 Index = GetTypeHash(AssetTag) & (Capacity - 1);
+			for (;; Index = (Index + 1) & (Capacity - 1))
+			{
+				FHyphenTagLoadProgress* Record = Slots[Index].load(std::memory_order_relaxed);
+				if (Record == nullptr)
+				{
+					break;
+				}
+				if (Record->AssetTag == AssetTag)
+				{
+					return Record;
+				}
+			}
+
+			if (Records.Num() >= MaxRecords)
+			{
+				UE_LOG(LogHyphenUtil, Warning, TEXT("Tag load progress table is full, progress of [%s] is not tracked"), *AssetTag.ToString());
+				return nullptr;
+			}
+			FHyphenTagLoadProgress* NewRecord = Records.Emplace_GetRef(MakeUnique<FHyphenTagLoadProgress>(AssetTag)).Get();
+			Slots[Index].store(NewRecord, std::memory_order_release);
+			return NewRecord;
+		}
+	};
+
+	FTagLoadProgressTable TagLoadProgressTable;
+
+	// LLM keeps every tag for the whole session, so only this many reference tags get their own entry.
+	constexpr int32 MaxReferenceTagLLMNames = 256;
+	TMap<FName, FName> ReferenceTagLLMNames;
+	FCriticalSection ReferenceTagLLMNamesCritical;
+
+	// Platform low memory warnings may arrive on any thread, the response runs on the game thread like the trim signal
+	void OnPlatformMemoryWarning(const FGenericMemoryWarningContext& Context)
+	{
+		AsyncTask(ENamedThreads::GameThread, []()
+		{
+			if (UHyphenAssetManager* AssetManager = Cast<UHyphenAssetManager>(GEngine ? GEngine->AssetManager : nullptr))
+			{
+				AssetManager->RespondToLowMemory();
+			}
+		});
+	}
+}
+
+float FHyphenWarmUpProgress::GetProgress() const
+{
+	const int32 Requested = RequestedAssets.load(std::memory_order_relaxed);
+	if (Requested <= 0)
+	{
+		return 1.f;
+	}
+	return FMath::Clamp(static_cast<float>(LoadedAssets.load(std::memory_order_relaxed)) / Requested, 0.f, 1.f);
+}
+
+bool FHyphenWarmUpProgress::IsComplete() const
+{
+	return bStarted.load(std::memory_order_acquire) && PendingRequests.load(std::memory_order_acquire) == 0;
+}
+
+float FHyphenTagLoadProgress::GetProgress() const
+{
+	const int32 Requested = RequestedAssets.load(std::memory_order_relaxed);
+	if (Requested <= 0)
+	{
+		return 1.f;
+	}
+	const int32 Finished = LoadedAssets.load(std::memory_order_relaxed) + FailedAssets.load(std::memory_order_relaxed);
+	return FMath::Clamp(static_cast<float>(Finished) / Requested, 0.f, 1.f);
+}
+
+bool FHyphenTagLoadProgress::IsComplete() const
+{
+	return LoadedAssets.load(std::memory_order_relaxed) + FailedAssets.load(std::memory_order_relaxed) >= RequestedAssets.load(std::memory_order_relaxed);
+}
+
+void FHyphenTagLoadProgress::Reset()
+{
+	RequestedAssets.store(0, std::memory_order_relaxed);
+	LoadedAssets.store(0, std::memory_order_relaxed);
+	FailedAssets.store(0, std::memory_order_relaxed);
+	LoadedBytes.store(0, std::memory_order_relaxed);
+}
 
 UHyphenAssetManager::UHyphenAssetManager()
 {
 }
 
+void UHyphenAssetManager::StartInitialLoading()
+{
+	Super::StartInitialLoading();
+	BindMemoryPressureDelegates();
+}
+
+FName UHyphenAssetManager::GetReferenceTagLLMName(FName ReferenceAssetTag)
+{
+	static const FName AssetManagerLLMName(TEXT("HyphenUtil/AssetManager"));
+	if (ReferenceAssetTag == NAME_None)
+	{
+		return AssetManagerLLMName;
+	}
+
+	FScopeLock LLMNamesLock(&HyphenAssetManager::ReferenceTagLLMNamesCritical);
+	if (const FName* LLMName = HyphenAssetManager::ReferenceTagLLMNames.Find(ReferenceAssetTag))
+	{
+		return *LLMName;
+	}
+	if (HyphenAssetManager::ReferenceTagLLMNames.Num() >= HyphenAssetManager::MaxReferenceTagLLMNames)
+	{
+		return AssetManagerLLMName;
+	}
+	return HyphenAssetManager::ReferenceTagLLMNames.Add(ReferenceAssetTag, FName(FString::Printf(TEXT("HyphenUtil/AssetManager/%s"), *ReferenceAssetTag.ToString())));
+}
+
 UHyphenAssetManager& UHyphenAssetManager::Get()
 {
 	UHyphenAssetManager* This = Cast<UHyphenAssetManager>(GEngine->AssetManager);
@@ -35,21 +181,63 @@ TSharedPtr<FStreamableHandle> UHyphenAssetManager::RequestAsyncLoad(const TArray
 	}
 
 	TArray<FSoftObjectPath> AssetPaths;
+	TSet<FSoftObjectPath> UniquePaths;
+	AssetPaths.Reserve(TargetsToStream.Num());
+	UniquePaths.Reserve(TargetsToStream.Num());
 	for(int32 i = 0;i<TargetsToStream.Num();i++)
 	{
 		const auto& Target = TargetsToStream[i];
 		if(Target.IsValid())
 		{
-			AssetPaths.AddUnique(Target);		
+			bool bAlreadyAdded = false;
+			UniquePaths.Add(Target, &bAlreadyAdded);
+			if (!bAlreadyAdded)
+			{
+				AssetPaths.Add(Target);
+			}
+		}
+	}
+	if (AssetPaths.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	LLM_SCOPE_BYTAG(HyphenUtil_AssetManager);
+	UHyphenAssetManager& This = Get();
+	TSharedPtr<FStreamableHandle> Result;
+	if (ReferenceAssetTag == NAME_None)
+	{
+		Result = GetStreamableManager().RequestAsyncLoad(MoveTemp(AssetPaths), MoveTemp(DelegateToCall), Priority, bManageActiveHandle, bStartStalled, MoveTemp(DebugName));
+	}
+	else
+	{
+		const int32 NumAssets = AssetPaths.Num();
+		This.NoteReferenceAssetRequested(ReferenceAssetTag, NumAssets);
+
+		// Filled once the handle exists, the completion reads the loaded objects from it
+		TSharedRef<TWeakPtr<FStreamableHandle>> HandleCell = MakeShared<TWeakPtr<FStreamableHandle>>();
+		FHyphenReferenceAssetLoadInfo LoadInfo{ReferenceAssetTag, AssetPaths, Priority, MoveTemp(DelegateToCall), FPlatformTime::Seconds()};
+		Result = GetStreamableManager().RequestAsyncLoad(MoveTemp(AssetPaths),
+		                                                 FStreamableDelegate::CreateUObject(&This, &UHyphenAssetManager::OnReferenceAssetRequestCompleted, MoveTemp(LoadInfo), HandleCell),
+		                                                 Priority, bManageActiveHandle, bStartStalled, MoveTemp(DebugName));
+		if (Result.IsValid())
+		{
+			*HandleCell = Result;
+			Result->BindCancelDelegate(FStreamableDelegate::CreateUObject(&This, &UHyphenAssetManager::OnReferenceAssetRequestCanceled, ReferenceAssetTag, NumAssets));
+		}
+		else
+		{
+			This.OnReferenceAssetRequestCanceled(ReferenceAssetTag, NumAssets);
 		}
 	}
-	auto Result =  GetStreamableManager().RequestAsyncLoad(AssetPaths, DelegateToCall, Priority, bManageActiveHandle, bStartStalled, DebugName);
 
-	if (ReferenceAssetTag != NAME_None)
+	// Tracked even while nothing prefetches, a prefetch started later must still wait for loads already in flight
+	if (Result.IsValid() && Priority >= This.PrefetchPauseMinPriority && Result->IsLoadingInProgress())
 	{
-		Result->BindCompleteDelegate(FStreamableDelegate::CreateUFunction(GEngine->AssetManager, "OnReferenceAssetLoaded", FHyphenReferenceAssetLoadInfo{ReferenceAssetTag, TargetsToStream, Priority, DelegateToCall}));
+		// Also drops finished handles, so the list stays bounded while no prefetch ticks
+		This.IsGameplayLoadInProgress();
+		This.GameplayLoadHandles.Add(Result);
 	}
-	
 	return Result;
 }
 
@@ -61,12 +249,8 @@ TSharedPtr<FStreamableHandle> UHyphenAssetManager::RequestAsyncLoad(const FSoftO
 	{
 		return nullptr;
 	}
-	auto Result= GetStreamableManager().RequestAsyncLoad(TargetToStream, DelegateToCall, Priority, bManageActiveHandle, bStartStalled, DebugName);
-	if (ReferenceAssetTag != NAME_None)
-	{
-		Result->BindCompleteDelegate(FStreamableDelegate::CreateUFunction(GEngine->AssetManager, "OnReferenceAssetLoaded", FHyphenReferenceAssetLoadInfo{ReferenceAssetTag, {TargetToStream}, Priority, DelegateToCall}));
-	}
-	return Result;
+	return RequestAsyncLoad(TArray<FSoftObjectPath>{TargetToStream}, ReferenceAssetTag, MoveTemp(DelegateToCall), Priority, bManageActiveHandle,
+	                        bStartStalled, MoveTemp(DebugName));
 }
 
 void UHyphenAssetManager::HoldAssetReference(FName ReferenceAssetTag)
@@ -80,6 +264,13 @@ void UHyphenAssetManager::HoldAssetReference(FName ReferenceAssetTag)
 	{
 		Get().ReferenceCounter.Emplace(ReferenceAssetTag, 1);
 	}
+
+	// Bring back what low memory evicted while the tag stayed held
+	FHyphenReferenceAssetLoadInfo EvictedLoad;
+	if (Get().EvictedTags.RemoveAndCopyValue(ReferenceAssetTag, EvictedLoad))
+	{
+		RequestAsyncLoad(EvictedLoad.LoadAssetPaths, ReferenceAssetTag, FStreamableDelegate(), EvictedLoad.Priority, false, false, TEXT("HyphenEvictedReload"));
+	}
 }
 
 void UHyphenAssetManager::ReleaseAssetReference(FName ReferenceAssetTag, bool bWarnIfNoReference)
@@ -91,11 +282,15 @@ void UHyphenAssetManager::ReleaseAssetReference(FName ReferenceAssetTag, bool bW
 		const int32 RefCount = Get().ReferenceCounter[ReferenceAssetTag];
 		if(RefCount == 0)
 		{
-			// if no object is referencing this asset, unload it
-			if(Get().ReferenceLoadedAssets.Contains(ReferenceAssetTag))
+			Get().TagReloadStats.FindOrAdd(ReferenceAssetTag).ReleaseCount++;
+			Get().TryPinReferenceTag(ReferenceAssetTag);
+			if (FHyphenTagLoadProgress* Progress = HyphenAssetManager::TagLoadProgressTable.Find(ReferenceAssetTag))
 			{
-				Get().ReferenceLoadedAssets.Remove(ReferenceAssetTag);
+				Progress->Reset();
 			}
+			// if no object is referencing this asset, unload it
+			Get().RemoveReferenceObjects(ReferenceAssetTag);
+			Get().EvictedTags.Remove(ReferenceAssetTag);
 			if(Get().ReferenceCounter.Contains(ReferenceAssetTag))
 			{
 				Get().ReferenceCounter.Remove(ReferenceAssetTag);
@@ -110,96 +305,1117 @@ void UHyphenAssetManager::ReleaseAssetReference(FName ReferenceAssetTag, bool bW
 
 void UHyphenAssetManager::FlushAllReferenceLoadedAssets()
 {
-	Get().ReferenceLoadedAssets.Empty();
+	if (Get().bDetectLeaksAfterFlush)
+	{
+		Get().CollectLeakCandidates();
+		if (!Get().LeakDetectionGCHandle.IsValid())
+		{
+			Get().LeakDetectionGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(&Get(), &UHyphenAssetManager::OnPostGarbageCollectDetectLeaks);
+		}
+	}
+	Get().WorldScopedReferences.Empty();
+	Get().CarriedOverReferences.Empty();
+	TArray<FName> PinnedTagNames;
+	Get().PinnedTags.GetKeys(PinnedTagNames);
+	for (const FName PinnedTag : PinnedTagNames)
+	{
+		Get().UnpinReferenceTag(PinnedTag, TEXT("flushed"));
+	}
+	for (const TUniquePtr<FHyphenTagLoadProgress>& Progress : HyphenAssetManager::TagLoadProgressTable.Records)
+	{
+		Progress->Reset();
+	}
+	TArray<FName> ReleasedTags;
+	Get().ReferenceLoadedAssets.GetKeys(ReleasedTags);
+	Get().EmptyReferenceObjects();
+	Get().EvictedTags.Empty();
 	Get().ReferenceCounter.Empty();
+	for (const FName ReleasedTag : ReleasedTags)
+	{
+		Get().OnReferenceTagReleased.Broadcast(ReleasedTag);
+	}
 }
 
-void UHyphenAssetManager::FlushReferenceLoadedAssets(FName ReferenceAssetTag)
+void UHyphenAssetManager::FlushAndDetectAssetLeaks()
 {
-	if(Get().ReferenceLoadedAssets.Contains(ReferenceAssetTag))
+	UHyphenAssetManager& This = Get();
+	// Candidates of an earlier flush are checked here too, the post-GC detection of bDetectLeaksAfterFlush is not needed
+	if (This.LeakDetectionGCHandle.IsValid())
 	{
-		Get().ReferenceLoadedAssets.Remove(ReferenceAssetTag);
+		FCoreUObjectDelegates::GetPostGarbageCollect().Remove(This.LeakDetectionGCHandle);
+		This.LeakDetectionGCHandle.Reset();
 	}
-	if(Get().ReferenceCounter.Contains(ReferenceAssetTag))
+	This.CollectLeakCandidates();
 	{
-		Get().ReferenceCounter.Remove(ReferenceAssetTag);
+		TGuardValue<bool> DetectLeaksAfterFlushGuard(This.bDetectLeaksAfterFlush, false);
+		FlushAllReferenceLoadedAssets();
 	}
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+	This.DetectLeaksFromCandidates();
 }
 
-void UHyphenAssetManager::AddLoadedAsset(const UObject* Asset)
+void UHyphenAssetManager::CollectLeakCandidates()
 {
-	if (ensureAlways(Asset))
+	LeakCandidates.Reserve(LeakCandidates.Num() + ReferenceObjectPool.Num());
+	for (const UObject* Object : ReferenceObjectPool)
+	{
+		if (Object)
+		{
+			LeakCandidates.Emplace(Object);
+		}
+	}
+	for (const TPair<FName, FPinnedTag>& PinnedTag : PinnedTags)
+	{
+		for (const UObject* Object : PinnedTag.Value.Objects)
+		{
+			LeakCandidates.Emplace(Object);
+		}
+	}
+}
+
+void UHyphenAssetManager::OnPostGarbageCollectDetectLeaks()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(LeakDetectionGCHandle);
+	LeakDetectionGCHandle.Reset();
+
+	// Searching references is not allowed inside the GC callback, run on the next tick
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+	{
+		DetectLeaksFromCandidates();
+		return false;
+	}));
+}
+
+void UHyphenAssetManager::DetectLeaksFromCandidates()
+{
+	if (LeakCandidates.Num() == 0)
+	{
+		return;
+	}
+
+	// Assets deliberately kept through AddLoadedAsset are not leaks
+	TSet<FObjectKey> KeptAssets;
 	{
 		FScopeLock LoadedAssetsLock(&LoadedAssetsCritical);
-		LoadedAssets.Add(Asset);
+		LoadedAssetIndices.GetKeys(KeptAssets);
+	}
+	// Objects held again by tags requested since the flush are not leaks either
+	for (const UObject* Object : ReferenceObjectPool)
+	{
+		KeptAssets.Add(Object);
 	}
+
+	HyphenUtil::DetectAssetLeaks(LeakCandidates, KeptAssets);
+	LeakCandidates.Empty();
 }
 
-void UHyphenAssetManager::DumpLoadedAssets()
+void UHyphenAssetManager::BindMemoryPressureDelegates()
 {
-	UE_LOG(LogHyphenUtil, Log, TEXT("========== Start Dumping Loaded Assets =========="));
+	if (!MemoryTrimHandle.IsValid())
+	{
+		MemoryTrimHandle = FCoreDelegates::GetMemoryTrimDelegate().AddUObject(this, &UHyphenAssetManager::OnMemoryTrim);
+		// The platform low memory warning is a single handler, keep one the project installed itself
+		if (!FPlatformMisc::HasMemoryWarningHandler())
+		{
+			FPlatformMisc::SetMemoryWarningHandler(&HyphenAssetManager::OnPlatformMemoryWarning);
+		}
+	}
+	if (LowMemoryPollSeconds > 0.f && LowMemoryAvailableBytes > 0 && !MemoryPollTickerHandle.IsValid())
+	{
+		MemoryPollTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UHyphenAssetManager::TickMemoryPoll), LowMemoryPollSeconds);
+	}
+}
 
-	for (const UObject* LoadedAsset : Get().LoadedAssets)
+void UHyphenAssetManager::OnMemoryTrim()
+{
+	// Platforms may signal from their main thread, the response touches UObjects and runs GC
+	AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UHyphenAssetManager>(this)]()
 	{
-		UE_LOG(LogHyphenUtil, Log, TEXT("  %s"), *GetNameSafe(LoadedAsset));
+		if (UHyphenAssetManager* This = WeakThis.Get())
+		{
+			This->RespondToLowMemory();
+		}
+	});
+}
+
+bool UHyphenAssetManager::TickMemoryPoll(float DeltaTime)
+{
+	if (IsAvailableMemoryLow(LowMemoryAvailableBytes))
+	{
+		RespondToLowMemory();
 	}
+	return true;
+}
 
-	UE_LOG(LogHyphenUtil, Log, TEXT("... %d assets in loaded pool"), Get().LoadedAssets.Num());
-	UE_LOG(LogHyphenUtil, Log, TEXT("========== Finish Dumping Loaded Assets =========="));
+bool UHyphenAssetManager::IsAvailableMemoryLow(int64 ThresholdBytes)
+{
+	return ThresholdBytes <= 0 || FPlatformMemory::GetStats().AvailablePhysical < static_cast<uint64>(ThresholdBytes);
 }
 
-void UHyphenAssetManager::DumpReferenceLoadedAssets()
+void UHyphenAssetManager::CollectGarbageForLowMemory(const TCHAR* Tier)
 {
-	UE_LOG(LogHyphenUtil, Display, TEXT("========== Start Dumping Reference Loaded Assets =========="));
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+	UE_LOG(LogHyphenUtil, Log, TEXT("Low memory: %s, %llu MB available after GC"), Tier, FPlatformMemory::GetStats().AvailablePhysical / (1024 * 1024));
+}
 
-	int LoadedCount = 0;
-	for (const auto& LoadedAssetPair : ReferenceLoadedAssets)
+void UHyphenAssetManager::RespondToLowMemory()
+{
+	check(IsInGameThread());
+	const double Now = FPlatformTime::Seconds();
+	if (IsGarbageCollecting() || Now - LastLowMemoryResponseTime < LowMemoryCooldownSeconds)
+	{
+		return;
+	}
+	LastLowMemoryResponseTime = Now;
+	UE_LOG(LogHyphenUtil, Warning, TEXT("Low memory: %llu MB available, releasing cached assets"), FPlatformMemory::GetStats().AvailablePhysical / (1024 * 1024));
+
+	// Tier 1, nothing needs these right now
+	CancelPrefetch();
+	TArray<FName> PinnedTagNames;
+	PinnedTags.GetKeys(PinnedTagNames);
+	for (const FName PinnedTag : PinnedTagNames)
+	{
+		UnpinReferenceTag(PinnedTag, TEXT("low memory"));
+	}
+	CollectGarbageForLowMemory(TEXT("dropped prefetch and pinned tags"));
+	if (!IsAvailableMemoryLow(LowMemoryAvailableBytes))
+	{
+		return;
+	}
+
+	// Tier 2, tags loaded through GetAsset or RequestAsyncLoad that no one holds
+	TArray<FName> UnheldTags;
+	for (const auto& TagPair : ReferenceLoadedAssets)
 	{
-		for (const UObject* LoadedAsset : LoadedAssetPair.Value.Objects)
+		if (!ReferenceCounter.Contains(TagPair.Key))
 		{
-			UE_LOG(LogHyphenUtil, Log, TEXT("  %s"), *GetNameSafe(LoadedAsset));
+			UnheldTags.Add(TagPair.Key);
 		}
 	}
+	for (const FName UnheldTag : UnheldTags)
+	{
+		FlushReferenceLoadedAssets(UnheldTag);
+	}
+	CollectGarbageForLowMemory(*FString::Printf(TEXT("evicted %d unheld tags"), UnheldTags.Num()));
+	if (!IsAvailableMemoryLow(LowMemoryAvailableBytes))
+	{
+		return;
+	}
 
-	UE_LOG(LogHyphenUtil, Log, TEXT("... %d assets in loaded pool"), LoadedCount);
-	UE_LOG(LogHyphenUtil, Display, TEXT("========== Finish Dumping Reference Loaded Assets =========="));
+	// Tier 3, objects of held tags that were only ever loaded at non-critical priority
+	TArray<FName> NonCriticalTags;
+	for (const auto& TagPair : ReferenceLoadedAssets)
+	{
+		if (TagPair.Value.Priority < LowMemoryCriticalPriority)
+		{
+			NonCriticalTags.Add(TagPair.Key);
+		}
+	}
+	for (const FName NonCriticalTag : NonCriticalTags)
+	{
+		UE_LOG(LogHyphenUtil, Warning, TEXT("Low memory: evicting held tag [%s]"), *NonCriticalTag.ToString());
+		EvictReferenceTag(NonCriticalTag);
+	}
+	CollectGarbageForLowMemory(*FString::Printf(TEXT("evicted %d non-critical held tags"), NonCriticalTags.Num()));
 }
 
-void UHyphenAssetManager::DumpReferenceCounters()
+void UHyphenAssetManager::EvictReferenceTag(FName ReferenceAssetTag)
 {
-	//for all pair of reference counter object and reference asset tag
-	for (const auto& CounterPair : ReferenceCounter)
+	const FReferenceTagSlots* TagSlots = ReferenceLoadedAssets.Find(ReferenceAssetTag);
+	if (TagSlots == nullptr)
 	{
-		UE_LOG(LogHyphenUtil, Log, TEXT("%s-%d"), *CounterPair.Key.ToString(), CounterPair.Value);
+		return;
+	}
+
+	// Hold counts and world scopes are untouched, so later releases still balance
+	FHyphenReferenceAssetLoadInfo& EvictedLoad = EvictedTags.FindOrAdd(ReferenceAssetTag);
+	EvictedLoad.AssetTag = ReferenceAssetTag;
+	EvictedLoad.Priority = TagSlots->Priority;
+	for (const int32 Slot : TagSlots->Slots)
+	{
+		if (const UObject* Object = ReferenceObjectPool[Slot])
+		{
+			EvictedLoad.LoadAssetPaths.AddUnique(FSoftObjectPath(Object));
+		}
+	}
+	if (FHyphenTagLoadProgress* Progress = HyphenAssetManager::TagLoadProgressTable.Find(ReferenceAssetTag))
+	{
+		Progress->Reset();
 	}
+	RemoveReferenceObjects(ReferenceAssetTag);
 }
 
-FHyphenReferenceAssetLoadComplete& UHyphenAssetManager::GetReferenceAssetLoadComplete()
+void UHyphenAssetManager::FlushReferenceLoadedAssets(FName ReferenceAssetTag)
 {
-	return Get().OnReferenceAssetLoadComplete;
+	Get().RemoveScopedReferences(ReferenceAssetTag);
+	if (Get().PinnedTags.Contains(ReferenceAssetTag))
+	{
+		Get().UnpinReferenceTag(ReferenceAssetTag, TEXT("flushed"));
+	}
+	if (FHyphenTagLoadProgress* Progress = HyphenAssetManager::TagLoadProgressTable.Find(ReferenceAssetTag))
+	{
+		Progress->Reset();
+	}
+	Get().RemoveReferenceObjects(ReferenceAssetTag);
+	Get().EvictedTags.Remove(ReferenceAssetTag);
+	if(Get().ReferenceCounter.Contains(ReferenceAssetTag))
+	{
+		Get().ReferenceCounter.Remove(ReferenceAssetTag);
+	}
 }
 
-void UHyphenAssetManager::OnReferenceAssetLoaded(const FHyphenReferenceAssetLoadInfo& AssetLoadInfo)
+void UHyphenAssetManager::HoldWorldAssetReference(FName ReferenceAssetTag, const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (!ensureAlwaysMsgf(World, TEXT("World-scoped hold of [%s] needs a valid world context"), *ReferenceAssetTag.ToString()))
+	{
+		return;
+	}
+	HoldAssetReference(ReferenceAssetTag);
+	Get().WorldScopedReferences.FindOrAdd(World).FindOrAdd(ReferenceAssetTag)++;
+	Get().BindWorldScopeDelegates();
+}
+
+void UHyphenAssetManager::ReleaseWorldAssetReference(FName ReferenceAssetTag, const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	TMap<FName, int32>* WorldReferences = World ? Get().WorldScopedReferences.Find(World) : nullptr;
+	int32* HoldCount = WorldReferences ? WorldReferences->Find(ReferenceAssetTag) : nullptr;
+	if (!ensureAlwaysMsgf(HoldCount, TEXT("[%s] has no world-scoped hold in this world"), *ReferenceAssetTag.ToString()))
+	{
+		return;
+	}
+	if (--(*HoldCount) == 0)
+	{
+		WorldReferences->Remove(ReferenceAssetTag);
+	}
+	ReleaseAssetReference(ReferenceAssetTag);
+}
+
+void UHyphenAssetManager::MoveAssetReferenceScope(FName ReferenceAssetTag, const UObject* WorldContextObject, EHyphenReferenceScope NewScope)
 {
-	for(const auto& AssetPath : AssetLoadInfo.LoadAssetPaths)
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	UHyphenAssetManager& This = Get();
+	if (NewScope == EHyphenReferenceScope::Session)
 	{
-		const auto* LoadedAsset = AssetPath.ResolveObject();
-		if (AssetLoadInfo.OnLoadComplete.IsBound())
+		TMap<FName, int32>* WorldReferences = This.WorldScopedReferences.Find(World);
+		int32* HoldCount = WorldReferences ? WorldReferences->Find(ReferenceAssetTag) : nullptr;
+		if (ensureAlwaysMsgf(HoldCount, TEXT("[%s] has no world-scoped hold to move"), *ReferenceAssetTag.ToString()) && --(*HoldCount) == 0)
 		{
-			AssetLoadInfo.OnLoadComplete.Execute();
+			WorldReferences->Remove(ReferenceAssetTag);
 		}
-		if (LoadedAsset != nullptr)
-		{	
-			if(ReferenceLoadedAssets.Contains(AssetLoadInfo.AssetTag) == false)
-			{
-				FHyphenReferenceAssetObjects AssetObjects;
-				AssetObjects.Objects.Emplace(LoadedAsset);
-				ReferenceLoadedAssets.Add(AssetLoadInfo.AssetTag, AssetObjects);
-			}
-			else
-			{
-				ReferenceLoadedAssets[AssetLoadInfo.AssetTag].Objects.Emplace(LoadedAsset);
-			}
+	}
+	else
+	{
+		// Only holds that are not already scoped to some world can move
+		int32 ScopedHolds = This.CarriedOverReferences.FindRef(ReferenceAssetTag);
+		for (const auto& WorldPair : This.WorldScopedReferences)
+		{
+			ScopedHolds += WorldPair.Value.FindRef(ReferenceAssetTag);
+		}
+		if (ensureAlwaysMsgf(This.ReferenceCounter.FindRef(ReferenceAssetTag) > ScopedHolds, TEXT("[%s] has no session-scoped hold to move"), *ReferenceAssetTag.ToString()))
+		{
+			This.WorldScopedReferences.FindOrAdd(World).FindOrAdd(ReferenceAssetTag)++;
+			This.BindWorldScopeDelegates();
+		}
+	}
+}
+
+void UHyphenAssetManager::CarryOverAssetReferences(const TArray<FName>& ReferenceAssetTags)
+{
+	Get().PendingCarryOverTags.Append(ReferenceAssetTags);
+	// The next game world clears the pending tags even when none of them had world-scoped holds
+	Get().BindWorldScopeDelegates();
+}
+
+void UHyphenAssetManager::BindWorldScopeDelegates()
+{
+	if (!WorldCleanupHandle.IsValid())
+	{
+		WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UHyphenAssetManager::OnWorldCleanup);
+		PostWorldInitializationHandle = FWorldDelegates::OnPostWorldInitialization.AddUObject(this, &UHyphenAssetManager::OnPostWorldInitialization);
+	}
+}
+
+void UHyphenAssetManager::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	TMap<FName, int32> WorldReferences;
+	if (!WorldScopedReferences.RemoveAndCopyValue(World, WorldReferences))
+	{
+		return;
+	}
+
+	for (const auto& ReferencePair : WorldReferences)
+	{
+		if (PendingCarryOverTags.Contains(ReferencePair.Key) || TravelCarryOverTags.Contains(ReferencePair.Key))
+		{
+			// Keep the holds alive across the travel boundary
+			CarriedOverReferences.FindOrAdd(ReferencePair.Key) += ReferencePair.Value;
+			continue;
+		}
+		for (int32 i = 0; i < ReferencePair.Value; i++)
+		{
+			ReleaseAssetReference(ReferencePair.Key, false);
 		}
 	}
 }
+
+void UHyphenAssetManager::OnPostWorldInitialization(UWorld* World, const UWorld::InitializationValues IVS)
+{
+	if (World == nullptr || !World->IsGameWorld())
+	{
+		return;
+	}
+
+	// The seamless travel transition map only bridges the two worlds, the destination adopts the holds
+	const FString TransitionMap = UGameMapsSettings::GetGameMapsSettings()->TransitionMap.GetLongPackageName();
+	if (!TransitionMap.IsEmpty() && UWorld::RemovePIEPrefix(World->GetOutermost()->GetName()) == TransitionMap)
+	{
+		return;
+	}
+
+	// Tags marked for this travel must not carry over later travels, whether or not they had holds to move
+	PendingCarryOverTags.Empty();
+	if (CarriedOverReferences.Num() == 0)
+	{
+		return;
+	}
+
+	TMap<FName, int32>& WorldReferences = WorldScopedReferences.FindOrAdd(World);
+	for (const auto& ReferencePair : CarriedOverReferences)
+	{
+		WorldReferences.FindOrAdd(ReferencePair.Key) += ReferencePair.Value;
+	}
+	UE_LOG(LogHyphenUtil, Log, TEXT("Carried %d reference tags over to world [%s]"), CarriedOverReferences.Num(), *World->GetName());
+	CarriedOverReferences.Empty();
+}
+
+void UHyphenAssetManager::RemoveScopedReferences(FName ReferenceAssetTag)
+{
+	for (auto& WorldPair : WorldScopedReferences)
+	{
+		WorldPair.Value.Remove(ReferenceAssetTag);
+	}
+	CarriedOverReferences.Remove(ReferenceAssetTag);
+}
+
+void UHyphenAssetManager::PrefetchAssets(const TArray<FSoftObjectPath>& AssetPaths)
+{
+	if (!FIoDispatcher::IsInitialized())
+	{
+		return;
+	}
+
+	UHyphenAssetManager& This = Get();
+	FIoDispatcher& IoDispatcher = FIoDispatcher::Get();
+	if (This.PrefetchQueueHead > 0)
+	{
+		This.PrefetchQueue.RemoveAt(0, This.PrefetchQueueHead, false);
+		This.PrefetchQueueHead = 0;
+	}
+	TSet<FName> PackageNames;
+	for (const FSoftObjectPath& AssetPath : AssetPaths)
+	{
+		const FName PackageName = AssetPath.GetLongPackageFName();
+		bool bAlreadyQueued = false;
+		PackageNames.Add(PackageName, &bAlreadyQueued);
+		if (PackageName.IsNone() || bAlreadyQueued || FindPackage(nullptr, *PackageName.ToString()) != nullptr)
+		{
+			continue;
+		}
+
+		const FIoChunkId ChunkId = CreateIoChunkId(FPackageId::FromName(PackageName).Value(), 0, EIoChunkType::ExportBundleData);
+		const TIoStatusOr<uint64> ChunkSize = IoDispatcher.GetSizeForChunk(ChunkId);
+		if (ChunkSize.IsOk())
+		{
+			This.PrefetchQueue.Add(FPrefetchChunk{ChunkId, ChunkSize.ValueOrDie()});
+		}
+	}
+
+	if (This.PrefetchQueueHead < This.PrefetchQueue.Num() && !This.PrefetchTickerHandle.IsValid())
+	{
+		This.PrefetchBudgetBytes = 0.0;
+		This.PrefetchTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(&This, &UHyphenAssetManager::TickPrefetch));
+	}
+}
+
+void UHyphenAssetManager::CancelPrefetch()
+{
+	UHyphenAssetManager& This = Get();
+	This.PrefetchQueue.Reset();
+	This.PrefetchQueueHead = 0;
+	if (This.PrefetchTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(This.PrefetchTickerHandle);
+		This.PrefetchTickerHandle.Reset();
+	}
+}
+
+bool UHyphenAssetManager::TickPrefetch(float DeltaTime)
+{
+	if (PrefetchQueueHead >= PrefetchQueue.Num())
+	{
+		PrefetchQueue.Reset();
+		PrefetchQueueHead = 0;
+		PrefetchTickerHandle.Reset();
+		return false;
+	}
+
+	// Allow at most one second of burst
+	PrefetchBudgetBytes = FMath::Min(PrefetchBudgetBytes + DeltaTime * PrefetchBytesPerSecond, static_cast<double>(PrefetchBytesPerSecond));
+	if (IsGameplayLoadInProgress())
+	{
+		return true;
+	}
+
+	FIoBatch Batch = FIoDispatcher::Get().NewBatch();
+	bool bIssued = false;
+	while (PrefetchQueueHead < PrefetchQueue.Num() && PrefetchBudgetBytes > 0.0
+		&& PrefetchReadsInFlight.load(std::memory_order_relaxed) < MaxPrefetchReadsInFlight)
+	{
+		const FPrefetchChunk& Chunk = PrefetchQueue[PrefetchQueueHead++];
+		PrefetchBudgetBytes -= Chunk.Size;
+		PrefetchReadsInFlight.fetch_add(1, std::memory_order_relaxed);
+		// The buffer is dropped as soon as it arrives, the read only warms the I/O caches
+		Batch.ReadWithCallback(Chunk.ChunkId, FIoReadOptions(), IoDispatcherPriority_Min,
+		                       [this](TIoStatusOr<FIoBuffer> Result)
+		                       {
+			                       PrefetchReadsInFlight.fetch_sub(1, std::memory_order_relaxed);
+		                       });
+		bIssued = true;
+	}
+	if (bIssued)
+	{
+		Batch.Issue();
+	}
+	return true;
+}
+
+bool UHyphenAssetManager::IsGameplayLoadInProgress()
+{
+	bool bLoading = false;
+	GameplayLoadHandles.RemoveAllSwap([&bLoading](const TWeakPtr<FStreamableHandle>& WeakHandle)
+	{
+		const TSharedPtr<FStreamableHandle> Handle = WeakHandle.Pin();
+		if (Handle.IsValid() && Handle->IsLoadingInProgress())
+		{
+			bLoading = true;
+			return false;
+		}
+		return true;
+	});
+	return bLoading;
+}
+
+void UHyphenAssetManager::AddLoadedAsset(const UObject* Asset)
+{
+	if (ensureAlways(Asset))
+	{
+		LLM_SCOPE_BYTAG(HyphenUtil_AssetManager);
+		FScopeLock LoadedAssetsLock(&LoadedAssetsCritical);
+		if (!ContainsLoadedAsset(Asset))
+		{
+			LoadedAssetIndices.Add(Asset, LoadedAssets.Add(Asset));
+		}
+		else if (FPinnedAsset* PinnedAsset = PinnedAssets.Find(Asset))
+		{
+			// Kept explicitly from now on, unpinning must leave it
+			PinnedAsset->bAddedByPin = false;
+		}
+	}
+}
+
+void UHyphenAssetManager::ReleaseLoadedAsset(const UObject* Asset)
+{
+	FScopeLock LoadedAssetsLock(&LoadedAssetsCritical);
+	if (FPinnedAsset* PinnedAsset = PinnedAssets.Find(Asset))
+	{
+		// Still needed by a pinned tag, the last unpin removes it instead
+		PinnedAsset->bAddedByPin = true;
+		return;
+	}
+	RemoveLoadedAsset(Asset);
+}
+
+bool UHyphenAssetManager::ContainsLoadedAsset(const UObject* Asset) const
+{
+	return LoadedAssetIndices.Contains(Asset);
+}
+
+void UHyphenAssetManager::RemoveLoadedAsset(const UObject* Asset)
+{
+	int32 Index = INDEX_NONE;
+	if (!LoadedAssetIndices.RemoveAndCopyValue(Asset, Index))
+	{
+		return;
+	}
+	LoadedAssets.RemoveAtSwap(Index, 1, false);
+	if (LoadedAssets.IsValidIndex(Index))
+	{
+		// The pointer may have been cleared by GC, the key of a destroyed object is simply never found again
+		if (const UObject* MovedAsset = LoadedAssets[Index])
+		{
+			LoadedAssetIndices.Add(MovedAsset, Index);
+		}
+	}
+}
+
+void UHyphenAssetManager::AddReferenceObjects(FName ReferenceAssetTag, TConstArrayView<UObject*> Objects)
+{
+	LLM_SCOPE_BYTAG(HyphenUtil_AssetManager);
+	FReferenceTagSlots& TagSlots = ReferenceLoadedAssets.FindOrAdd(ReferenceAssetTag);
+	TagSlots.Objects.Reserve(TagSlots.Objects.Num() + Objects.Num());
+	for (const UObject* Object : Objects)
+	{
+		bool bAlreadyHeld = false;
+		TagSlots.Objects.Add(Object, &bAlreadyHeld);
+		if (Object == nullptr || bAlreadyHeld)
+		{
+			continue;
+		}
+		int32 Slot;
+		if (ReferenceObjectFreeSlots.Num() > 0)
+		{
+			Slot = ReferenceObjectFreeSlots.Pop(false);
+			ReferenceObjectPool[Slot] = Object;
+		}
+		else
+		{
+			Slot = ReferenceObjectPool.Add(Object);
+		}
+		TagSlots.Slots.Add(Slot);
+	}
+}
+
+void UHyphenAssetManager::AddLoadedReferenceObject(FName ReferenceAssetTag, UObject* Object)
+{
+	// Nothing was requested, load progress and reload stats stay as they are
+	AddReferenceObjects(ReferenceAssetTag, MakeArrayView(&Object, 1));
+	int32& TagPriority = ReferenceLoadedAssets.FindChecked(ReferenceAssetTag).Priority;
+	TagPriority = FMath::Max(TagPriority, 0);
+}
+
+void UHyphenAssetManager::RemoveReferenceObjects(FName ReferenceAssetTag)
+{
+	FReferenceTagSlots TagSlots;
+	if (!ReferenceLoadedAssets.RemoveAndCopyValue(ReferenceAssetTag, TagSlots))
+	{
+		return;
+	}
+	for (const int32 Slot : TagSlots.Slots)
+	{
+		ReferenceObjectPool[Slot] = nullptr;
+	}
+	ReferenceObjectFreeSlots.Append(TagSlots.Slots);
+
+	// Give memory back once no tag holds anything
+	if (ReferenceLoadedAssets.Num() == 0)
+	{
+		EmptyReferenceObjects();
+	}
+	OnReferenceTagReleased.Broadcast(ReferenceAssetTag);
+}
+
+void UHyphenAssetManager::EmptyReferenceObjects()
+{
+	ReferenceLoadedAssets.Empty();
+	ReferenceObjectPool.Empty();
+	ReferenceObjectFreeSlots.Empty();
+}
+
+namespace HyphenAssetManager
+{
+	template <typename FunctionType>
+	void WithAssetManager(FunctionType&& Function)
+	{
+		if (UHyphenAssetManager* AssetManager = Cast<UHyphenAssetManager>(GEngine ? GEngine->AssetManager : nullptr))
+		{
+			Function(*AssetManager);
+		}
+	}
+
+	static FAutoConsoleCommand DumpLoadedAssetsCommand(
+		TEXT("HyphenUtil.DumpLoadedAssets"),
+		TEXT("Logs all assets kept in memory by the HyphenAssetManager."),
+		FConsoleCommandDelegate::CreateLambda([]() { WithAssetManager([](UHyphenAssetManager&) { UHyphenAssetManager::DumpLoadedAssets(); }); }));
+
+	static FAutoConsoleCommand DumpReferenceLoadedAssetsCommand(
+		TEXT("HyphenUtil.DumpReferenceLoadedAssets"),
+		TEXT("Logs all assets held by reference tags."),
+		FConsoleCommandDelegate::CreateLambda([]() { WithAssetManager([](UHyphenAssetManager& AssetManager) { AssetManager.DumpReferenceLoadedAssets(); }); }));
+
+	static FAutoConsoleCommand DumpReferenceCountersCommand(
+		TEXT("HyphenUtil.DumpReferenceCounters"),
+		TEXT("Logs the hold count of every reference tag."),
+		FConsoleCommandDelegate::CreateLambda([]() { WithAssetManager([](UHyphenAssetManager& AssetManager) { AssetManager.DumpReferenceCounters(); }); }));
+
+	static FAutoConsoleCommand FlushAndDetectAssetLeaksCommand(
+		TEXT("HyphenUtil.FlushAndDetectAssetLeaks"),
+		TEXT("Flushes all reference tags, runs a full GC and reports the referencer chains of held assets that survived."),
+		FConsoleCommandDelegate::CreateLambda([]() { WithAssetManager([](UHyphenAssetManager&) { UHyphenAssetManager::FlushAndDetectAssetLeaks(); }); }));
+
+	static FAutoConsoleCommand RespondToLowMemoryCommand(
+		TEXT("HyphenUtil.RespondToLowMemory"),
+		TEXT("Runs the low memory response of the HyphenAssetManager as if the platform had signaled memory pressure."),
+		FConsoleCommandDelegate::CreateLambda([]() { WithAssetManager([](UHyphenAssetManager& AssetManager) { AssetManager.RespondToLowMemory(); }); }));
+
+	static FAutoConsoleCommand DumpPinnedTagsCommand(
+		TEXT("HyphenUtil.DumpPinnedTags"),
+		TEXT("Logs reference tags pinned by adaptive pinning and recent pin decisions."),
+		FConsoleCommandDelegate::CreateLambda([]() { WithAssetManager([](UHyphenAssetManager& AssetManager) { AssetManager.DumpPinnedTags(); }); }));
+}
+
+void UHyphenAssetManager::DumpLoadedAssets()
+{
+	UE_LOG(LogHyphenUtil, Log, TEXT("========== Start Dumping Loaded Assets =========="));
+
+	for (const UObject* LoadedAsset : Get().LoadedAssets)
+	{
+		UE_LOG(LogHyphenUtil, Log, TEXT("  %s"), *GetNameSafe(LoadedAsset));
+	}
+
+	UE_LOG(LogHyphenUtil, Log, TEXT("... %d assets in loaded pool"), Get().LoadedAssets.Num());
+	UE_LOG(LogHyphenUtil, Log, TEXT("========== Finish Dumping Loaded Assets =========="));
+}
+
+void UHyphenAssetManager::DumpReferenceLoadedAssets()
+{
+	UE_LOG(LogHyphenUtil, Display, TEXT("========== Start Dumping Reference Loaded Assets =========="));
+
+	int LoadedCount = 0;
+	for (const auto& LoadedAssetPair : ReferenceLoadedAssets)
+	{
+		for (const int32 Slot : LoadedAssetPair.Value.Slots)
+		{
+			UE_LOG(LogHyphenUtil, Log, TEXT("  %s"), *GetNameSafe(ReferenceObjectPool[Slot]));
+		}
+		LoadedCount += LoadedAssetPair.Value.Slots.Num();
+	}
+
+	UE_LOG(LogHyphenUtil, Log, TEXT("... %d assets in loaded pool"), LoadedCount);
+	UE_LOG(LogHyphenUtil, Display, TEXT("========== Finish Dumping Reference Loaded Assets =========="));
+}
+
+void UHyphenAssetManager::DumpReferenceCounters()
+{
+	//for all pair of reference counter object and reference asset tag
+	for (const auto& CounterPair : ReferenceCounter)
+	{
+		UE_LOG(LogHyphenUtil, Log, TEXT("%s-%d"), *CounterPair.Key.ToString(), CounterPair.Value);
+	}
+	for (const auto& WorldPair : WorldScopedReferences)
+	{
+		for (const auto& ReferencePair : WorldPair.Value)
+		{
+			UE_LOG(LogHyphenUtil, Log, TEXT("%s-%d (world %s)"), *ReferencePair.Key.ToString(), ReferencePair.Value, *GetNameSafe(WorldPair.Key.ResolveObjectPtr()));
+		}
+	}
+	for (const auto& ReferencePair : CarriedOverReferences)
+	{
+		UE_LOG(LogHyphenUtil, Log, TEXT("%s-%d (carried over)"), *ReferencePair.Key.ToString(), ReferencePair.Value);
+	}
+}
+
+void UHyphenAssetManager::DumpPinnedTags()
+{
+	UE_LOG(LogHyphenUtil, Display, TEXT("========== Start Dumping Pinned Tags =========="));
+
+	const double Now = FPlatformTime::Seconds();
+	for (const auto& PinnedPair : PinnedTags)
+	{
+		const FTagReloadStats& Stats = TagReloadStats.FindRef(PinnedPair.Key);
+		UE_LOG(LogHyphenUtil, Log, TEXT("  %s: %lld bytes, %d reloads, %d releases, score %.1f, idle %.0fs"), *PinnedPair.Key.ToString(),
+		       PinnedPair.Value.Bytes, Stats.ReloadCount, Stats.ReleaseCount, PinnedPair.Value.Score, Now - Stats.LastRequestTime);
+	}
+	UE_LOG(LogHyphenUtil, Log, TEXT("... %d tags pinned, %lld / %lld bytes"), PinnedTags.Num(), PinnedBytes, PinMemoryCapBytes);
+
+	UE_LOG(LogHyphenUtil, Log, TEXT("Recent pin decisions:"));
+	for (const FString& Decision : PinDecisions)
+	{
+		UE_LOG(LogHyphenUtil, Log, TEXT("  %s"), *Decision);
+	}
+	UE_LOG(LogHyphenUtil, Display, TEXT("========== Finish Dumping Pinned Tags =========="));
+}
+
+FHyphenReferenceAssetLoadComplete& UHyphenAssetManager::GetReferenceAssetLoadComplete()
+{
+	return Get().OnReferenceAssetLoadComplete;
+}
+
+FHyphenReferenceTagReleased& UHyphenAssetManager::GetReferenceTagReleased()
+{
+	return Get().OnReferenceTagReleased;
+}
+
+const FHyphenTagLoadProgress* UHyphenAssetManager::FindTagLoadProgress(FName ReferenceAssetTag)
+{
+	return HyphenAssetManager::TagLoadProgressTable.Find(ReferenceAssetTag);
+}
+
+float UHyphenAssetManager::GetTagsLoadProgress(TConstArrayView<FName> ReferenceAssetTags)
+{
+	int32 Requested = 0;
+	int32 Finished = 0;
+	for (const FName ReferenceAssetTag : ReferenceAssetTags)
+	{
+		if (const FHyphenTagLoadProgress* Progress = FindTagLoadProgress(ReferenceAssetTag))
+		{
+			Requested += Progress->RequestedAssets.load(std::memory_order_relaxed);
+			Finished += Progress->LoadedAssets.load(std::memory_order_relaxed) + Progress->FailedAssets.load(std::memory_order_relaxed);
+		}
+	}
+	return Requested > 0 ? FMath::Clamp(static_cast<float>(Finished) / Requested, 0.f, 1.f) : 1.f;
+}
+
+FHyphenTagLoadProgress* UHyphenAssetManager::FindOrAddTagLoadProgress(FName ReferenceAssetTag)
+{
+	return HyphenAssetManager::TagLoadProgressTable.FindOrAdd(ReferenceAssetTag);
+}
+
+void UHyphenAssetManager::NoteReferenceAssetRequested(FName ReferenceAssetTag, int32 NumAssets)
+{
+	LLM_SCOPE_BYTAG(HyphenUtil_AssetManager);
+	if (FHyphenTagLoadProgress* Progress = FindOrAddTagLoadProgress(ReferenceAssetTag))
+	{
+		Progress->RequestedAssets.fetch_add(NumAssets, std::memory_order_relaxed);
+	}
+
+	FTagReloadStats& Stats = TagReloadStats.FindOrAdd(ReferenceAssetTag);
+	Stats.LastRequestTime = FPlatformTime::Seconds();
+	if (Stats.ReleaseCount > 0 && !IsReferenceTagResident(ReferenceAssetTag))
+	{
+		Stats.ReloadCount++;
+	}
+}
+
+bool UHyphenAssetManager::IsReferenceTagResident(FName ReferenceAssetTag) const
+{
+	return ReferenceLoadedAssets.Contains(ReferenceAssetTag) || PinnedTags.Contains(ReferenceAssetTag);
+}
+
+void UHyphenAssetManager::TryPinReferenceTag(FName ReferenceAssetTag)
+{
+	if (PinMemoryCapBytes <= 0 || PinnedTags.Contains(ReferenceAssetTag))
+	{
+		return;
+	}
+	const FTagReloadStats* Stats = TagReloadStats.Find(ReferenceAssetTag);
+	const FReferenceTagSlots* TagSlots = ReferenceLoadedAssets.Find(ReferenceAssetTag);
+	if (Stats == nullptr || TagSlots == nullptr || Stats->ReloadCount < PinMinReloadCount || Stats->LastLoadBytes > PinMemoryCapBytes)
+	{
+		return;
+	}
+
+	const double Score = Stats->GetScore();
+	const int64 Bytes = Stats->LastLoadBytes;
+
+	// Make room by displacing pins that cost less to reload, but only if enough of them exist
+	TArray<FName> Displaced;
+	if (PinnedBytes + Bytes > PinMemoryCapBytes)
+	{
+		TArray<TPair<double, FName>> Candidates;
+		for (const auto& PinnedPair : PinnedTags)
+		{
+			if (PinnedPair.Value.Score < Score)
+			{
+				Candidates.Emplace(PinnedPair.Value.Score, PinnedPair.Key);
+			}
+		}
+		Candidates.Sort([](const TPair<double, FName>& A, const TPair<double, FName>& B) { return A.Key < B.Key; });
+
+		int64 FreedBytes = 0;
+		for (const auto& Candidate : Candidates)
+		{
+			if (PinnedBytes - FreedBytes + Bytes <= PinMemoryCapBytes)
+			{
+				break;
+			}
+			FreedBytes += PinnedTags[Candidate.Value].Bytes;
+			Displaced.Add(Candidate.Value);
+		}
+		if (PinnedBytes - FreedBytes + Bytes > PinMemoryCapBytes)
+		{
+			AddPinDecision(FString::Printf(TEXT("skip %s: %lld bytes, score %.1f does not fit in cap"), *ReferenceAssetTag.ToString(), Bytes, Score));
+			return;
+		}
+	}
+	for (const FName DisplacedTag : Displaced)
+	{
+		UnpinReferenceTag(DisplacedTag, TEXT("displaced"));
+	}
+
+	FPinnedTag& Pin = PinnedTags.Add(ReferenceAssetTag);
+	Pin.Bytes = Bytes;
+	Pin.Score = Score;
+	{
+		FScopeLock LoadedAssetsLock(&LoadedAssetsCritical);
+		for (const int32 Slot : TagSlots->Slots)
+		{
+			const UObject* Asset = ReferenceObjectPool[Slot];
+			if (Asset == nullptr)
+			{
+				continue;
+			}
+			// Objects shared with other pinned tags or kept through AddLoadedAsset stay until their last owner lets go
+			FPinnedAsset& PinnedAsset = PinnedAssets.FindOrAdd(Asset);
+			if (PinnedAsset.PinCount++ == 0 && !ContainsLoadedAsset(Asset))
+			{
+				LoadedAssetIndices.Add(Asset, LoadedAssets.Add(Asset));
+				PinnedAsset.bAddedByPin = true;
+			}
+			Pin.Objects.Add(Asset);
+		}
+	}
+	PinnedBytes += Bytes;
+	AddPinDecision(FString::Printf(TEXT("pin %s: %d reloads, %lld bytes, %.3fs load, score %.1f"), *ReferenceAssetTag.ToString(),
+	                               Stats->ReloadCount, Bytes, Stats->LastLoadSeconds, Score));
+
+	if (!PinTickerHandle.IsValid())
+	{
+		PinTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UHyphenAssetManager::TickPinnedTags), 10.f);
+	}
+}
+
+void UHyphenAssetManager::UnpinReferenceTag(FName ReferenceAssetTag, const TCHAR* Reason)
+{
+	FPinnedTag Pin;
+	if (!PinnedTags.RemoveAndCopyValue(ReferenceAssetTag, Pin))
+	{
+		return;
+	}
+	{
+		FScopeLock LoadedAssetsLock(&LoadedAssetsCritical);
+		for (const UObject* Asset : Pin.Objects)
+		{
+			FPinnedAsset* PinnedAsset = PinnedAssets.Find(Asset);
+			if (PinnedAsset == nullptr || --PinnedAsset->PinCount > 0)
+			{
+				continue;
+			}
+			if (PinnedAsset->bAddedByPin)
+			{
+				RemoveLoadedAsset(Asset);
+			}
+			PinnedAssets.Remove(Asset);
+		}
+	}
+	PinnedBytes -= Pin.Bytes;
+	AddPinDecision(FString::Printf(TEXT("unpin %s (%s): %lld bytes"), *ReferenceAssetTag.ToString(), Reason, Pin.Bytes));
+
+	if (PinnedTags.Num() == 0 && PinTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(PinTickerHandle);
+		PinTickerHandle.Reset();
+	}
+}
+
+bool UHyphenAssetManager::TickPinnedTags(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	TArray<FName> ColdTags;
+	for (const auto& PinnedPair : PinnedTags)
+	{
+		const FTagReloadStats* Stats = TagReloadStats.Find(PinnedPair.Key);
+		if (Stats == nullptr || Now - Stats->LastRequestTime > PinColdSeconds)
+		{
+			ColdTags.Add(PinnedPair.Key);
+		}
+	}
+	for (const FName ColdTag : ColdTags)
+	{
+		UnpinReferenceTag(ColdTag, TEXT("cold"));
+	}
+	return PinTickerHandle.IsValid();
+}
+
+void UHyphenAssetManager::AddPinDecision(FString&& Decision)
+{
+	UE_LOG(LogHyphenUtil, Log, TEXT("Adaptive pinning: %s"), *Decision);
+	if (PinDecisions.Num() >= 64)
+	{
+		PinDecisions.RemoveAt(0);
+	}
+	PinDecisions.Add(MoveTemp(Decision));
+}
+
+void UHyphenAssetManager::StartWarmUp()
+{
+	if (WarmUpProgress.bStarted.load(std::memory_order_relaxed) || GIsEditor)
+	{
+		return;
+	}
+
+	// Reserve up front, completion delegates refer to requests by index
+	WarmUpRequests.Reserve(WarmUpAssets.Num());
+	for (const FHyphenReferenceAssetLoadInfo& Entry : WarmUpAssets)
+	{
+		if (Entry.LoadAssetPaths.Num() == 0)
+		{
+			continue;
+		}
+		const int32 RequestIndex = WarmUpRequests.AddDefaulted();
+		FWarmUpRequest& Request = WarmUpRequests[RequestIndex];
+		Request.AssetTag = Entry.AssetTag != NAME_None ? Entry.AssetTag : WarmUpReferenceTag;
+		Request.NumAssets = Entry.LoadAssetPaths.Num();
+
+		HoldAssetReference(Request.AssetTag);
+		WarmUpProgress.RequestedAssets.fetch_add(Request.NumAssets, std::memory_order_relaxed);
+		WarmUpProgress.PendingRequests.fetch_add(1, std::memory_order_release);
+
+		Request.Handle = RequestAsyncLoad(Entry.LoadAssetPaths, Request.AssetTag,
+		                                  FStreamableDelegate::CreateUObject(this, &UHyphenAssetManager::OnWarmUpRequestLoaded, RequestIndex),
+		                                  Entry.Priority, false, false, TEXT("HyphenWarmUp"));
+		if (!Request.Handle.IsValid())
+		{
+			OnWarmUpRequestLoaded(RequestIndex);
+		}
+	}
+
+	if (WarmUpRequests.Num() > 0)
+	{
+		WarmUpMapLoadedHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UHyphenAssetManager::OnWarmUpMapLoaded);
+	}
+
+	UE_LOG(LogHyphenUtil, Log, TEXT("Warm-up started: %d requests, %d assets"), WarmUpRequests.Num(),
+	       WarmUpProgress.RequestedAssets.load(std::memory_order_relaxed));
+	WarmUpProgress.bStarted.store(true, std::memory_order_release);
+}
+
+const FHyphenWarmUpProgress& UHyphenAssetManager::GetWarmUpProgress()
+{
+	return WarmUpProgress;
+}
+
+void UHyphenAssetManager::OnWarmUpRequestLoaded(int32 RequestIndex)
+{
+	if (!WarmUpRequests.IsValidIndex(RequestIndex) || WarmUpRequests[RequestIndex].bLoaded)
+	{
+		return;
+	}
+
+	FWarmUpRequest& Request = WarmUpRequests[RequestIndex];
+	Request.bLoaded = true;
+	WarmUpProgress.LoadedAssets.fetch_add(Request.NumAssets, std::memory_order_relaxed);
+	WarmUpProgress.PendingRequests.fetch_sub(1, std::memory_order_release);
+
+	// The first map came up before this request finished, release it now
+	if (bWarmUpMapLoaded)
+	{
+		ReleaseWarmUpRequest(Request);
+	}
+}
+
+void UHyphenAssetManager::OnWarmUpMapLoaded(UWorld* LoadedWorld)
+{
+	bWarmUpMapLoaded = true;
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(WarmUpMapLoadedHandle);
+	WarmUpMapLoadedHandle.Reset();
+
+	// Requests still in flight are released when they complete so their I/O is not wasted
+	for (FWarmUpRequest& Request : WarmUpRequests)
+	{
+		if (Request.bLoaded)
+		{
+			ReleaseWarmUpRequest(Request);
+		}
+	}
+}
+
+void UHyphenAssetManager::ReleaseWarmUpRequest(FWarmUpRequest& Request)
+{
+	if (Request.bReleased)
+	{
+		return;
+	}
+	Request.bReleased = true;
+	Request.Handle.Reset();
+	ReleaseAssetReference(Request.AssetTag, false);
+}
+
+void UHyphenAssetManager::OnReferenceAssetLoaded(const FHyphenReferenceAssetLoadInfo& AssetLoadInfo)
+{
+	TArray<UObject*> LoadedObjects;
+	LoadedObjects.Reserve(AssetLoadInfo.LoadAssetPaths.Num());
+	for (const FSoftObjectPath& AssetPath : AssetLoadInfo.LoadAssetPaths)
+	{
+		if (UObject* LoadedAsset = AssetPath.ResolveObject())
+		{
+			LoadedObjects.Add(LoadedAsset);
+		}
+	}
+	FinishReferenceAssetLoad(AssetLoadInfo, LoadedObjects);
+}
+
+void UHyphenAssetManager::OnReferenceAssetRequestCompleted(FHyphenReferenceAssetLoadInfo AssetLoadInfo, TSharedRef<TWeakPtr<FStreamableHandle>> HandleCell)
+{
+	const TSharedPtr<FStreamableHandle> Handle = HandleCell->Pin();
+	if (!Handle.IsValid())
+	{
+		// Completed before RequestAsyncLoad returned the handle
+		OnReferenceAssetLoaded(AssetLoadInfo);
+		return;
+	}
+
+	TArray<UObject*> LoadedObjects;
+	Handle->GetLoadedAssets(LoadedObjects);
+	FinishReferenceAssetLoad(AssetLoadInfo, LoadedObjects);
+}
+
+void UHyphenAssetManager::OnReferenceAssetRequestCanceled(FName ReferenceAssetTag, int32 NumAssets)
+{
+	if (FHyphenTagLoadProgress* Progress = FindOrAddTagLoadProgress(ReferenceAssetTag))
+	{
+		Progress->FailedAssets.fetch_add(NumAssets, std::memory_order_relaxed);
+	}
+}
+
+void UHyphenAssetManager::FinishReferenceAssetLoad(const FHyphenReferenceAssetLoadInfo& AssetLoadInfo, TConstArrayView<UObject*> LoadedObjects)
+{
+	int64 LoadedBytes = 0;
+	for (UObject* LoadedAsset : LoadedObjects)
+	{
+		LoadedBytes += LoadedAsset->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	}
+
+	if (FHyphenTagLoadProgress* Progress = FindOrAddTagLoadProgress(AssetLoadInfo.AssetTag))
+	{
+		Progress->LoadedAssets.fetch_add(LoadedObjects.Num(), std::memory_order_relaxed);
+		Progress->FailedAssets.fetch_add(FMath::Max(AssetLoadInfo.LoadAssetPaths.Num() - LoadedObjects.Num(), 0), std::memory_order_relaxed);
+		Progress->LoadedBytes.fetch_add(LoadedBytes, std::memory_order_relaxed);
+	}
+
+	AddReferenceObjects(AssetLoadInfo.AssetTag, LoadedObjects);
+	int32& TagPriority = ReferenceLoadedAssets.FindChecked(AssetLoadInfo.AssetTag).Priority;
+	TagPriority = FMath::Max(TagPriority, AssetLoadInfo.Priority);
+
+	if (AssetLoadInfo.RequestTime > 0.0)
+	{
+		FTagReloadStats& Stats = TagReloadStats.FindOrAdd(AssetLoadInfo.AssetTag);
+		Stats.LastLoadBytes = LoadedBytes;
+		Stats.LastLoadSeconds = FPlatformTime::Seconds() - AssetLoadInfo.RequestTime;
+	}
+
+	AssetLoadInfo.OnLoadComplete.ExecuteIfBound();
+
+	// Listeners get every request completed this frame in one broadcast
+	FHyphenReferenceAssetLoadInfo& PendingLoadInfo = PendingLoadCompletes.Add_GetRef(AssetLoadInfo);
+	PendingLoadInfo.OnLoadComplete.Unbind();
+	if (!LoadCompleteTickerHandle.IsValid())
+	{
+		LoadCompleteTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UHyphenAssetManager::BroadcastReferenceAssetLoadComplete));
+	}
+}
+
+bool UHyphenAssetManager::BroadcastReferenceAssetLoadComplete(float DeltaTime)
+{
+	LoadCompleteTickerHandle.Reset();
+	const TArray<FHyphenReferenceAssetLoadInfo> CompletedLoads = MoveTemp(PendingLoadCompletes);
+	PendingLoadCompletes.Reset();
+	OnReferenceAssetLoadComplete.Broadcast(CompletedLoads);
+	return false;
+}
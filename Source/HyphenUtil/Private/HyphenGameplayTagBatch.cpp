@@ -0,0 +1,159 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenGameplayTagBatch.h"
+
+#include "HyphenGameplayTagCache.h"
+#include "Async/ParallelFor.h"
+
+#if PLATFORM_CPU_X86_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS
+#include <emmintrin.h>
+#define HYPHENUTIL_TAG_SCAN_SSE2 1
+#else
+#define HYPHENUTIL_TAG_SCAN_SSE2 0
+#endif
+
+namespace HyphenUtil
+{
+	namespace
+	{
+		// Below this many unique names the task overhead is larger than the lookups.
+		constexpr int32 MinParallelTagNames = 1024;
+
+		// Returns the index of the first space in Text, or INDEX_NONE. Scans eight characters per step with SSE2.
+		int32 FindTagSpace(FStringView Text)
+		{
+			const TCHAR* Data = Text.GetData();
+			const int32 Len = Text.Len();
+			int32 Index = 0;
+#if HYPHENUTIL_TAG_SCAN_SSE2
+			if constexpr (sizeof(TCHAR) == 2)
+			{
+				const __m128i Space = _mm_set1_epi16(TEXT(' '));
+				for (; Index + 8 <= Len; Index += 8)
+				{
+					const __m128i Characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + Index));
+					const uint32 Mask = static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi16(Characters, Space)));
+					if (Mask != 0)
+					{
+						// Two mask bits per character
+						return Index + static_cast<int32>(FMath::CountTrailingZeros(Mask)) / 2;
+					}
+				}
+			}
+#endif
+			for (; Index < Len; Index++)
+			{
+				if (Data[Index] == TEXT(' '))
+				{
+					return Index;
+				}
+			}
+			return INDEX_NONE;
+		}
+
+		// Tags are case insensitive, so identical strings are deduplicated ignoring case.
+		struct FTagNameKeyFuncs : BaseKeyFuncs<TPair<FStringView, int32>, FStringView, false>
+		{
+			static FStringView GetSetKey(const TPair<FStringView, int32>& Element)
+			{
+				return Element.Key;
+			}
+			static bool Matches(FStringView A, FStringView B)
+			{
+				return A.Equals(B, ESearchCase::IgnoreCase);
+			}
+			static uint32 GetKeyHash(FStringView Key)
+			{
+				uint32 Hash = 2166136261u;
+				for (const TCHAR Character : Key)
+				{
+					Hash = (Hash ^ static_cast<uint32>(FChar::ToLower(Character))) * 16777619u;
+				}
+				return Hash;
+			}
+		};
+	}
+
+	FGameplayTagBatchResult GetGameplayTagsFromStrings(TConstArrayView<FStringView> TagNames)
+	{
+		FGameplayTagBatchResult Result;
+		Result.Tags.SetNum(TagNames.Num());
+
+		// Only strings with whitespace are copied, the others are resolved from the input directly
+		TArray<FString> CleanTagNames;
+		TArray<FStringView> UniqueTagNames;
+		TArray<int32> UniqueIndices;
+		UniqueIndices.SetNumUninitialized(TagNames.Num());
+		TMap<FStringView, int32, FDefaultSetAllocator, FTagNameKeyFuncs> UniqueIndexByName;
+		UniqueIndexByName.Reserve(TagNames.Num());
+		for (int32 Index = 0; Index < TagNames.Num(); Index++)
+		{
+			FStringView TagName = TagNames[Index];
+			const int32 SpaceIndex = FindTagSpace(TagName);
+			if (SpaceIndex != INDEX_NONE)
+			{
+				FString& CleanTagName = CleanTagNames.AddDefaulted_GetRef();
+				CleanTagName.Reserve(TagName.Len());
+				CleanTagName.Append(TagName.Left(SpaceIndex));
+				for (const TCHAR Character : TagName.RightChop(SpaceIndex))
+				{
+					if (Character != TEXT(' '))
+					{
+						CleanTagName.AppendChar(Character);
+					}
+				}
+				// The string buffer stays in place when CleanTagNames grows
+				TagName = CleanTagName;
+			}
+
+			if (const int32* UniqueIndex = UniqueIndexByName.Find(TagName))
+			{
+				UniqueIndices[Index] = *UniqueIndex;
+			}
+			else
+			{
+				UniqueIndices[Index] = UniqueTagNames.Add(TagName);
+				UniqueIndexByName.Add(TagName, UniqueIndices[Index]);
+			}
+		}
+
+		// Index lookups are lock-free, the tag manager fallback locks its own tag map
+		TArray<FGameplayTag> UniqueTags;
+		UniqueTags.SetNum(UniqueTagNames.Num());
+		ParallelFor(UniqueTagNames.Num(), [&UniqueTagNames, &UniqueTags](int32 Index)
+		{
+			const FStringView TagName = UniqueTagNames[Index];
+			if (TagName.IsEmpty() || FGameplayTagIndex::Get().FindChild(NAME_None, TagName, UniqueTags[Index]))
+			{
+				return;
+			}
+			const FName TagFName(TagName, FNAME_Find);
+			if (!TagFName.IsNone())
+			{
+				UniqueTags[Index] = FGameplayTag::RequestGameplayTag(TagFName, false);
+			}
+		}, UniqueTagNames.Num() < MinParallelTagNames ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+		for (int32 Index = 0; Index < TagNames.Num(); Index++)
+		{
+			Result.Tags[Index] = UniqueTags[UniqueIndices[Index]];
+			if (!Result.Tags[Index].IsValid())
+			{
+				Result.FailedIndices.Add(Index);
+			}
+		}
+		return Result;
+	}
+
+	FGameplayTagBatchResult GetGameplayTagsFromStrings(TConstArrayView<FString> TagNames)
+	{
+		TArray<FStringView> TagNameViews;
+		TagNameViews.Reserve(TagNames.Num());
+		for (const FString& TagName : TagNames)
+		{
+			TagNameViews.Add(TagName);
+		}
+		return GetGameplayTagsFromStrings(TagNameViews);
+	}
+}
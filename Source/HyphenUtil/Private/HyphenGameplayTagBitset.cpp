@@ -0,0 +1,100 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenGameplayTagBitset.h"
+
+#include "HyphenGameplayTagBatch.h"
+#include "HyphenGameplayTagCache.h"
+
+namespace HyphenUtil
+{
+	FGameplayTagBitContainer::FGameplayTagBitContainer(const FGameplayTagContainer& Container)
+	{
+		AppendTags(Container);
+	}
+
+	FGameplayTagBitContainer FGameplayTagBitContainer::FromStrings(TConstArrayView<FStringView> TagNames)
+	{
+		FGameplayTagBitContainer BitContainer;
+		for (const FGameplayTag& Tag : GetGameplayTagsFromStrings(TagNames).Tags)
+		{
+			if (Tag.IsValid())
+			{
+				BitContainer.AddTag(Tag);
+			}
+		}
+		return BitContainer;
+	}
+
+	bool FGameplayTagBitContainer::AddTag(const FGameplayTag& Tag)
+	{
+		if (!Tag.IsValid())
+		{
+			return false;
+		}
+		const bool bIndexed = FGameplayTagIndex::Get().ForEachDenseIndexWithParents(Tag, [this, bExplicit = true](int32 DenseIndex) mutable
+		{
+			if (bExplicit)
+			{
+				ExplicitTags.Set(DenseIndex);
+				bExplicit = false;
+			}
+			// Parents of a tag already in the set are in it as well
+			if (TagsWithParents.Test(DenseIndex))
+			{
+				return false;
+			}
+			TagsWithParents.Set(DenseIndex);
+			return true;
+		});
+		// Registered after the last index update, dropping it would make queries answer wrong
+		if (!bIndexed)
+		{
+			UnindexedTags.AddTag(Tag);
+		}
+		return true;
+	}
+
+	void FGameplayTagBitContainer::AppendTags(const FGameplayTagContainer& Container)
+	{
+		for (const FGameplayTag& Tag : Container)
+		{
+			AddTag(Tag);
+		}
+	}
+
+	void FGameplayTagBitContainer::Reset()
+	{
+		ExplicitTags.Reset();
+		TagsWithParents.Reset();
+		UnindexedTags.Reset();
+	}
+
+	FGameplayTagContainer FGameplayTagBitContainer::ToContainer() const
+	{
+		FGameplayTagContainer Container;
+		const FGameplayTagIndex& Index = FGameplayTagIndex::Get();
+		ExplicitTags.ForEachSetBit([&Container, &Index](int32 DenseIndex)
+		{
+			Container.AddTag(Index.GetDenseTag(DenseIndex));
+		});
+		Container.AppendTags(UnindexedTags);
+		return Container;
+	}
+
+	bool FGameplayTagBitContainer::HasTag(const FGameplayTag& Tag) const
+	{
+		return TagsWithParents.Test(FGameplayTagIndex::Get().FindDenseIndex(Tag)) || UnindexedTags.HasTag(Tag);
+	}
+
+	bool FGameplayTagBitContainer::HasTagExact(const FGameplayTag& Tag) const
+	{
+		return ExplicitTags.Test(FGameplayTagIndex::Get().FindDenseIndex(Tag)) || UnindexedTags.HasTagExact(Tag);
+	}
+
+	bool FGameplayTagBitContainer::HasUnindexedTag(int32 DenseIndex, bool bExact) const
+	{
+		const FGameplayTag Tag = FGameplayTagIndex::Get().GetDenseTag(DenseIndex);
+		return bExact ? UnindexedTags.HasTagExact(Tag) : UnindexedTags.HasTag(Tag);
+	}
+}
@@ -0,0 +1,576 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenGameplayTagCache.h"
+
+#include "GameplayTagsManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeRWLock.h"
+
+namespace HyphenUtil
+{
+	FGameplayTagCache& FGameplayTagCache::Get()
+	{
+		static FGameplayTagCache Cache;
+		return Cache;
+	}
+
+	bool FGameplayTagCache::FindCombined(FName ParentTagName, FName ChildName, FGameplayTag& OutTag) const
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const FGameplayTag* CombinedTag = CombinedTags.Find(TPair<FName, FName>(ParentTagName, ChildName)))
+		{
+			OutTag = *CombinedTag;
+			return true;
+		}
+		return false;
+	}
+
+	void FGameplayTagCache::AddCombined(FName ParentTagName, FName ChildName, const FGameplayTag& Tag)
+	{
+		FWriteScopeLock WriteLock(Lock);
+		CombinedTags.Add(TPair<FName, FName>(ParentTagName, ChildName), Tag);
+	}
+
+	void FGameplayTagCache::Invalidate()
+	{
+		FWriteScopeLock WriteLock(Lock);
+		CombinedTags.Empty();
+	}
+
+	int32 FGameplayTagCache::Num() const
+	{
+		FReadScopeLock ReadLock(Lock);
+		return CombinedTags.Num();
+	}
+
+	namespace
+	{
+		// Returns the slot holding the entry Match accepts, or the empty slot it would be inserted into.
+		template <typename EntryType, typename MatchType>
+		std::atomic<EntryType*>& FindSlot(std::atomic<EntryType*>* Slots, int32 Capacity, uint32 Hash, MatchType&& Match)
+		{
+			for (uint32 Index = Hash & (Capacity - 1);; Index = (Index + 1) & (Capacity - 1))
+			{
+				EntryType* Entry = Slots[Index].load(std::memory_order_acquire);
+				if (Entry == nullptr || Match(*Entry))
+				{
+					return Slots[Index];
+				}
+			}
+		}
+
+		uint32 GetChildHash(FName ParentTagName, FName SimpleTagName)
+		{
+			return HashCombine(GetTypeHash(ParentTagName), GetTypeHash(SimpleTagName));
+		}
+	}
+
+	FGameplayTagIndex::FSnapshot::FSnapshot(int32 InCapacity)
+		: Capacity(InCapacity)
+		, MaxEntries(InCapacity * 3 / 4)
+		, Tags(MakeUnique<std::atomic<const FTagEntry*>[]>(InCapacity))
+		, Children(MakeUnique<std::atomic<const FTagEntry*>[]>(InCapacity))
+		, DenseNames(MakeUnique<std::atomic<const FTagEntry*>[]>(InCapacity))
+		, DenseEntries(MakeUnique<std::atomic<const FTagEntry*>[]>(InCapacity))
+	{
+		check(FMath::IsPowerOfTwo(InCapacity));
+	}
+
+	const FGameplayTagIndex::FTagEntry* FGameplayTagIndex::FSnapshot::FindTag(FName TagName) const
+	{
+		return FindSlot(Tags.Get(), Capacity, GetTypeHash(TagName), [TagName](const FTagEntry& Entry)
+		{
+			return Entry.Tag.GetTagName() == TagName;
+		}).load(std::memory_order_acquire);
+	}
+
+	const FGameplayTagIndex::FTagEntry* FGameplayTagIndex::FSnapshot::FindChild(FName ParentTagName, FName SimpleTagName) const
+	{
+		return FindSlot(Children.Get(), Capacity, GetChildHash(ParentTagName, SimpleTagName), [ParentTagName, SimpleTagName](const FTagEntry& Entry)
+		{
+			return Entry.ParentTagName == ParentTagName && Entry.SimpleTagName == SimpleTagName;
+		}).load(std::memory_order_acquire);
+	}
+
+	const FGameplayTagIndex::FTagEntry* FGameplayTagIndex::FSnapshot::FindDense(FName TagName) const
+	{
+		return FindSlot(DenseNames.Get(), Capacity, GetTypeHash(TagName), [TagName](const FTagEntry& Entry)
+		{
+			return Entry.Tag.GetTagName() == TagName;
+		}).load(std::memory_order_acquire);
+	}
+
+	const FGameplayTagIndex::FTagEntry* FGameplayTagIndex::FSnapshot::GetDense(int32 DenseIndex) const
+	{
+		return DenseIndex >= 0 && DenseIndex < MaxEntries ? DenseEntries[DenseIndex].load(std::memory_order_acquire) : nullptr;
+	}
+
+	bool FGameplayTagIndex::FSnapshot::AddLive(const FTagEntry& Entry)
+	{
+		const FName TagName = Entry.Tag.GetTagName();
+		std::atomic<const FTagEntry*>& TagSlot = FindSlot(Tags.Get(), Capacity, GetTypeHash(TagName), [TagName](const FTagEntry& Other)
+		{
+			return Other.Tag.GetTagName() == TagName;
+		});
+		if (TagSlot.load(std::memory_order_relaxed) != nullptr)
+		{
+			return false;
+		}
+		std::atomic<const FTagEntry*>& ChildSlot = FindSlot(Children.Get(), Capacity, GetChildHash(Entry.ParentTagName, Entry.SimpleTagName), [&Entry](const FTagEntry& Other)
+		{
+			return Other.ParentTagName == Entry.ParentTagName && Other.SimpleTagName == Entry.SimpleTagName;
+		});
+		if (ChildSlot.load(std::memory_order_relaxed) == nullptr)
+		{
+			ChildSlot.store(&Entry, std::memory_order_release);
+		}
+		TagSlot.store(&Entry, std::memory_order_release);
+		NumTags.store(NumTags.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	void FGameplayTagIndex::FSnapshot::AddDense(const FTagEntry& Entry)
+	{
+		const FName TagName = Entry.Tag.GetTagName();
+		FindSlot(DenseNames.Get(), Capacity, GetTypeHash(TagName), [TagName](const FTagEntry& Other)
+		{
+			return Other.Tag.GetTagName() == TagName;
+		}).store(&Entry, std::memory_order_release);
+	}
+
+	/**
+	 * The outermost scope of a thread stores the current epoch in the slot of the thread before it loads the snapshot, both
+	 * sequentially consistent. A snapshot it can load is unpublished after that epoch was read, so it is retired at a later
+	 * epoch and stays until the slot is cleared or moved past it. Nested scopes keep the epoch of the outer one.
+	 * Threads that found no free slot are counted together instead.
+	 */
+	class FGameplayTagIndex::FReadScope
+	{
+	public:
+		explicit FReadScope(const FGameplayTagIndex& InIndex)
+			: Index(InIndex)
+		{
+			FThreadState& State = ThreadState;
+			if (State.Depth++ == 0)
+			{
+				if (State.Slot == nullptr && !State.bOverflow)
+				{
+					State.Slot = Index.ClaimReaderSlot();
+					State.bOverflow = State.Slot == nullptr;
+				}
+				if (State.Slot)
+				{
+					State.Slot->Epoch.store(Index.Epoch.load());
+				}
+				else
+				{
+					Index.OverflowReaders.fetch_add(1);
+				}
+			}
+			Snapshot = Index.Snapshot.load();
+		}
+		~FReadScope()
+		{
+			FThreadState& State = ThreadState;
+			if (--State.Depth == 0)
+			{
+				if (State.Slot)
+				{
+					State.Slot->Epoch.store(0, std::memory_order_release);
+				}
+				else
+				{
+					Index.OverflowReaders.fetch_sub(1, std::memory_order_release);
+				}
+			}
+		}
+
+		const FSnapshot* Get() const { return Snapshot; }
+
+	private:
+		// The slot stays claimed by its thread until the thread exits
+		struct FThreadState
+		{
+			~FThreadState()
+			{
+				if (Slot)
+				{
+					Slot->bClaimed.store(false, std::memory_order_release);
+				}
+			}
+
+			FReaderSlot* Slot = nullptr;
+			int32 Depth = 0;
+			bool bOverflow = false;
+		};
+		static thread_local FThreadState ThreadState;
+
+		const FGameplayTagIndex& Index;
+		const FSnapshot* Snapshot = nullptr;
+	};
+
+	thread_local FGameplayTagIndex::FReadScope::FThreadState FGameplayTagIndex::FReadScope::ThreadState;
+
+	FGameplayTagIndex& FGameplayTagIndex::Get()
+	{
+		static FGameplayTagIndex Index;
+		return Index;
+	}
+
+	FGameplayTagIndex::~FGameplayTagIndex()
+	{
+		delete Snapshot.exchange(nullptr);
+		for (const FRetiredSnapshot& RetiredSnapshot : RetiredSnapshots)
+		{
+			delete RetiredSnapshot.Snapshot;
+		}
+	}
+
+	FGameplayTagIndex::FReaderSlot* FGameplayTagIndex::ClaimReaderSlot() const
+	{
+		for (FReaderSlot& Slot : ReaderSlots)
+		{
+			bool bClaimed = false;
+			if (Slot.bClaimed.compare_exchange_strong(bClaimed, true, std::memory_order_acquire))
+			{
+				return &Slot;
+			}
+		}
+		return nullptr;
+	}
+
+	bool FGameplayTagIndex::FindTag(FName TagName, FGameplayTag& OutTag) const
+	{
+		const FReadScope ReadScope(*this);
+		const FSnapshot* CurrentSnapshot = ReadScope.Get();
+		const FTagEntry* Entry = CurrentSnapshot ? CurrentSnapshot->FindTag(TagName) : nullptr;
+		if (Entry == nullptr)
+		{
+			return false;
+		}
+		OutTag = Entry->Tag;
+		return true;
+	}
+
+	bool FGameplayTagIndex::FindChild(FName ParentTagName, FName ChildName, FGameplayTag& OutTag) const
+	{
+		const FReadScope ReadScope(*this);
+		const FSnapshot* CurrentSnapshot = ReadScope.Get();
+		if (CurrentSnapshot == nullptr)
+		{
+			return false;
+		}
+		if (const FTagEntry* Entry = CurrentSnapshot->FindChild(ParentTagName, ChildName))
+		{
+			OutTag = Entry->Tag;
+			return true;
+		}
+		// Only a child of several segments can still be found
+		TStringBuilder<128> ChildString;
+		ChildString << ChildName;
+		int32 DotIndex = INDEX_NONE;
+		return ChildString.ToView().FindChar(TEXT('.'), DotIndex) && FindChild(*CurrentSnapshot, ParentTagName, ChildString.ToView(), OutTag);
+	}
+
+	bool FGameplayTagIndex::FindChild(FName ParentTagName, FStringView ChildName, FGameplayTag& OutTag) const
+	{
+		const FReadScope ReadScope(*this);
+		const FSnapshot* CurrentSnapshot = ReadScope.Get();
+		return CurrentSnapshot && FindChild(*CurrentSnapshot, ParentTagName, ChildName, OutTag);
+	}
+
+	bool FGameplayTagIndex::FindChild(const FSnapshot& CurrentSnapshot, FName ParentTagName, FStringView ChildName, FGameplayTag& OutTag)
+	{
+		if (ChildName.IsEmpty())
+		{
+			return false;
+		}
+
+		FName CurrentTagName = ParentTagName;
+		const FTagEntry* Entry = nullptr;
+		FStringView RemainingName = ChildName;
+		while (!RemainingName.IsEmpty())
+		{
+			int32 DotIndex = INDEX_NONE;
+			if (!RemainingName.FindChar(TEXT('.'), DotIndex))
+			{
+				DotIndex = RemainingName.Len();
+			}
+			// A segment missing from the name table cannot be part of any tag
+			const FName SegmentName(RemainingName.Left(DotIndex), FNAME_Find);
+			Entry = SegmentName.IsNone() ? nullptr : CurrentSnapshot.FindChild(CurrentTagName, SegmentName);
+			if (Entry == nullptr)
+			{
+				return false;
+			}
+			CurrentTagName = Entry->Tag.GetTagName();
+			RemainingName.RightChopInline(DotIndex + 1);
+		}
+		OutTag = Entry->Tag;
+		return true;
+	}
+
+	void FGameplayTagIndex::Update()
+	{
+		check(IsInGameThread());
+		if (SourceUpdateDepth > 0)
+		{
+			return;
+		}
+		FGameplayTagContainer AllTags;
+		UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, false);
+
+		// Tags already indexed cost one probe, only the new ones get entries
+		const FSnapshot* CurrentSnapshot = Snapshot.load(std::memory_order_relaxed);
+		TArray<FGameplayTag> NewTags;
+		for (const FGameplayTag& Tag : AllTags)
+		{
+			if (CurrentSnapshot == nullptr || CurrentSnapshot->FindTag(Tag.GetTagName()) == nullptr)
+			{
+				NewTags.Add(Tag);
+			}
+		}
+		const bool bTagsRemoved = CurrentSnapshot && CurrentSnapshot->NumTags.load(std::memory_order_relaxed) + NewTags.Num() != AllTags.Num();
+		IndexTags(NewTags, bTagsRemoved ? &AllTags : nullptr);
+	}
+
+	void FGameplayTagIndex::BeginSourceUpdate()
+	{
+		check(IsInGameThread());
+		SourceUpdateDepth++;
+	}
+
+	void FGameplayTagIndex::EndSourceUpdate(TConstArrayView<FGameplayTag> AddedTags)
+	{
+		check(IsInGameThread() && SourceUpdateDepth > 0);
+		SourceUpdateDepth--;
+		// Before the first update the whole tree is indexed at once
+		if (Snapshot.load(std::memory_order_relaxed) != nullptr)
+		{
+			IndexTags(AddedTags, nullptr);
+		}
+	}
+
+	void FGameplayTagIndex::IndexTags(TConstArrayView<FGameplayTag> NewTags, const FGameplayTagContainer* LiveTags)
+	{
+		FSnapshot* CurrentSnapshot = Snapshot.load(std::memory_order_relaxed);
+
+		// Entries of the batch first, so parents in the same batch are linked before anything is published.
+		// Adding a tag implicitly adds its missing parents, they are queued behind it.
+		const int32 FirstNewEntry = Entries.Num();
+		TArray<FGameplayTag> PendingTags(NewTags.GetData(), NewTags.Num());
+		TMap<FName, const FTagEntry*> BatchEntries;
+		TArray<const FTagEntry*> LiveEntries;
+		for (int32 PendingIndex = 0; PendingIndex < PendingTags.Num(); PendingIndex++)
+		{
+			const FGameplayTag Tag = PendingTags[PendingIndex];
+			if (!Tag.IsValid() || BatchEntries.Contains(Tag.GetTagName()))
+			{
+				continue;
+			}
+			const FTagEntry* Entry = CurrentSnapshot ? CurrentSnapshot->FindDense(Tag.GetTagName()) : nullptr;
+			if (Entry == nullptr)
+			{
+				FTagEntry& NewEntry = *Entries.Emplace_GetRef(MakeUnique<FTagEntry>());
+				NewEntry.Tag = Tag;
+				NewEntry.DenseIndex = Entries.Num() - 1;
+				TStringBuilder<256> TagString;
+				TagString << Tag.GetTagName();
+				int32 DotIndex = INDEX_NONE;
+				if (TagString.ToView().FindLastChar(TEXT('.'), DotIndex))
+				{
+					NewEntry.ParentTagName = FName(TagString.ToView().Left(DotIndex));
+					NewEntry.SimpleTagName = FName(TagString.ToView().RightChop(DotIndex + 1));
+				}
+				else
+				{
+					NewEntry.SimpleTagName = Tag.GetTagName();
+				}
+				Entry = &NewEntry;
+			}
+			BatchEntries.Add(Tag.GetTagName(), Entry);
+			LiveEntries.Add(Entry);
+
+			if (!LiveTags && !Entry->ParentTagName.IsNone() && !BatchEntries.Contains(Entry->ParentTagName)
+				&& (CurrentSnapshot == nullptr || CurrentSnapshot->FindTag(Entry->ParentTagName) == nullptr))
+			{
+				PendingTags.Add(FGameplayTag::RequestGameplayTag(Entry->ParentTagName, false));
+			}
+		}
+		for (int32 EntryIndex = FirstNewEntry; EntryIndex < Entries.Num(); EntryIndex++)
+		{
+			FTagEntry& Entry = *Entries[EntryIndex];
+			const FTagEntry* const* ParentEntry = BatchEntries.Find(Entry.ParentTagName);
+			const FTagEntry* ParentDenseEntry = ParentEntry ? *ParentEntry : CurrentSnapshot ? CurrentSnapshot->FindDense(Entry.ParentTagName) : nullptr;
+			Entry.ParentDenseIndex = ParentDenseEntry ? ParentDenseEntry->DenseIndex : INDEX_NONE;
+		}
+
+		if (CurrentSnapshot && !LiveTags && Entries.Num() <= CurrentSnapshot->MaxEntries)
+		{
+			// Readers may see the batch partially, but a tag is only reachable by name once its parents have dense entries
+			for (int32 EntryIndex = FirstNewEntry; EntryIndex < Entries.Num(); EntryIndex++)
+			{
+				CurrentSnapshot->DenseEntries[EntryIndex].store(Entries[EntryIndex].Get(), std::memory_order_release);
+			}
+			for (int32 EntryIndex = FirstNewEntry; EntryIndex < Entries.Num(); EntryIndex++)
+			{
+				CurrentSnapshot->AddDense(*Entries[EntryIndex]);
+			}
+			for (const FTagEntry* Entry : LiveEntries)
+			{
+				CurrentSnapshot->AddLive(*Entry);
+			}
+			NumEntries.store(Entries.Num(), std::memory_order_release);
+			return;
+		}
+
+		// Full tables grow to twice the entries, removed tags leave the live tables. Entries are shared, not copied.
+		FSnapshot* NewSnapshot = new FSnapshot(FMath::Max(1024, (int32)FMath::RoundUpToPowerOfTwo(Entries.Num() * 2)));
+		for (const TUniquePtr<FTagEntry>& Entry : Entries)
+		{
+			NewSnapshot->DenseEntries[Entry->DenseIndex].store(Entry.Get(), std::memory_order_relaxed);
+			NewSnapshot->AddDense(*Entry);
+		}
+		if (LiveTags)
+		{
+			for (const FGameplayTag& Tag : *LiveTags)
+			{
+				if (const FTagEntry* Entry = NewSnapshot->FindDense(Tag.GetTagName()))
+				{
+					NewSnapshot->AddLive(*Entry);
+				}
+			}
+		}
+		else
+		{
+			for (int32 SlotIndex = 0; CurrentSnapshot && SlotIndex < CurrentSnapshot->Capacity; SlotIndex++)
+			{
+				if (const FTagEntry* Entry = CurrentSnapshot->Tags[SlotIndex].load(std::memory_order_relaxed))
+				{
+					NewSnapshot->AddLive(*Entry);
+				}
+			}
+			for (const FTagEntry* Entry : LiveEntries)
+			{
+				NewSnapshot->AddLive(*Entry);
+			}
+		}
+		NumEntries.store(Entries.Num(), std::memory_order_release);
+
+		RetireSnapshot(Snapshot.exchange(NewSnapshot));
+	}
+
+	void FGameplayTagIndex::RetireSnapshot(const FSnapshot* ReplacedSnapshot)
+	{
+		if (ReplacedSnapshot == nullptr)
+		{
+			return;
+		}
+		RetiredSnapshots.Add(FRetiredSnapshot{ReplacedSnapshot, Epoch.fetch_add(1) + 1});
+		if (!RetiredSnapshotsTickerHandle.IsValid())
+		{
+			RetiredSnapshotsTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FGameplayTagIndex::TickRetiredSnapshots));
+		}
+	}
+
+	bool FGameplayTagIndex::FreeRetiredSnapshots()
+	{
+		if (OverflowReaders.load() != 0)
+		{
+			return RetiredSnapshots.Num() == 0;
+		}
+		// Lookups keep moving to the current epoch, so the oldest one in flight catches up with every retired snapshot
+		uint64 OldestReaderEpoch = MAX_uint64;
+		for (const FReaderSlot& Slot : ReaderSlots)
+		{
+			const uint64 ReaderEpoch = Slot.Epoch.load();
+			if (ReaderEpoch != 0)
+			{
+				OldestReaderEpoch = FMath::Min(OldestReaderEpoch, ReaderEpoch);
+			}
+		}
+		RetiredSnapshots.RemoveAll([OldestReaderEpoch](const FRetiredSnapshot& RetiredSnapshot)
+		{
+			if (RetiredSnapshot.RetireEpoch > OldestReaderEpoch)
+			{
+				return false;
+			}
+			delete RetiredSnapshot.Snapshot;
+			return true;
+		});
+		return RetiredSnapshots.Num() == 0;
+	}
+
+	bool FGameplayTagIndex::TickRetiredSnapshots(float DeltaTime)
+	{
+		if (!FreeRetiredSnapshots())
+		{
+			return true;
+		}
+		RetiredSnapshotsTickerHandle.Reset();
+		return false;
+	}
+
+	void FGameplayTagIndex::Reset()
+	{
+		check(IsInGameThread());
+		RetireSnapshot(Snapshot.exchange(nullptr));
+		// Lookups take microseconds, wait for the ones in flight instead of freeing under them
+		while (!FreeRetiredSnapshots())
+		{
+			FPlatformProcess::Yield();
+		}
+		if (RetiredSnapshotsTickerHandle.IsValid())
+		{
+			FTSTicker::GetCoreTicker().RemoveTicker(RetiredSnapshotsTickerHandle);
+			RetiredSnapshotsTickerHandle.Reset();
+		}
+		RetiredSnapshots.Empty();
+		NumEntries.store(0, std::memory_order_release);
+		Entries.Empty();
+	}
+
+	int32 FGameplayTagIndex::Num() const
+	{
+		const FReadScope ReadScope(*this);
+		const FSnapshot* CurrentSnapshot = ReadScope.Get();
+		return CurrentSnapshot ? CurrentSnapshot->NumTags.load(std::memory_order_relaxed) : 0;
+	}
+
+	int32 FGameplayTagIndex::FindDenseIndex(const FGameplayTag& Tag) const
+	{
+		const FReadScope ReadScope(*this);
+		const FSnapshot* CurrentSnapshot = ReadScope.Get();
+		const FTagEntry* Entry = CurrentSnapshot ? CurrentSnapshot->FindDense(Tag.GetTagName()) : nullptr;
+		return Entry ? Entry->DenseIndex : INDEX_NONE;
+	}
+
+	bool FGameplayTagIndex::ForEachDenseIndexWithParents(const FGameplayTag& Tag, TFunctionRef<bool(int32)> Visitor) const
+	{
+		const FReadScope ReadScope(*this);
+		const FSnapshot* CurrentSnapshot = ReadScope.Get();
+		const FTagEntry* Entry = CurrentSnapshot ? CurrentSnapshot->FindDense(Tag.GetTagName()) : nullptr;
+		if (Entry == nullptr)
+		{
+			return false;
+		}
+		for (; Entry && Visitor(Entry->DenseIndex); Entry = CurrentSnapshot->GetDense(Entry->ParentDenseIndex))
+		{
+		}
+		return true;
+	}
+
+	FGameplayTag FGameplayTagIndex::GetDenseTag(int32 DenseIndex) const
+	{
+		const FReadScope ReadScope(*this);
+		const FSnapshot* CurrentSnapshot = ReadScope.Get();
+		const FTagEntry* Entry = CurrentSnapshot ? CurrentSnapshot->GetDense(DenseIndex) : nullptr;
+		return Entry ? Entry->Tag : FGameplayTag();
+	}
+
+	int32 FGameplayTagIndex::NumDense() const
+	{
+		return NumEntries.load(std::memory_order_acquire);
+	}
+}
@@ -0,0 +1,39 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenGameplayTagLiteral.h"
+
+#include "HyphenUtilLibrary.h"
+
+namespace HyphenUtil
+{
+	namespace Private
+	{
+		FGameplayTag FTagLiteralHandle::Resolve(const TCHAR* TagName, int32 Len)
+		{
+			uint8 ExpectedState = Unresolved;
+			if (State.compare_exchange_strong(ExpectedState, Resolving, std::memory_order_acquire))
+			{
+				const FGameplayTag ResolvedTag = RequestGameplayTag(FStringView(TagName, Len), true);
+				if (!ResolvedTag.IsValid())
+				{
+					// Tags may not be registered yet this early, try again on the next call
+					State.store(Unresolved, std::memory_order_release);
+					return ResolvedTag;
+				}
+				Tag = ResolvedTag;
+				ResolvedName = TagName;
+				ResolvedLen = Len;
+				State.store(Resolved, std::memory_order_release);
+				return Tag;
+			}
+
+			// Another thread is resolving the same literal
+			while (State.load(std::memory_order_acquire) == Resolving)
+			{
+				FPlatformProcess::Yield();
+			}
+			return State.load(std::memory_order_acquire) == Resolved ? Tag : FGameplayTag();
+		}
+	}
+}
@@ -0,0 +1,124 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenGameplayTagRegistration.h"
+
+#include "GameplayTagsManager.h"
+#include "HyphenGameplayTagCache.h"
+#include "HyphenUtilLogs.h"
+#include "NativeGameplayTags.h"
+
+namespace HyphenUtil
+{
+	namespace
+	{
+		// Tags registered after native tags were done stay registered while their FNativeGameplayTag lives
+		TArray<TUniquePtr<FNativeGameplayTag>> GeneratedNativeTags;
+
+		bool IsDoneAddingNativeTags()
+		{
+			static bool bDoneAddingNativeTags = false;
+			static bool bRegistered = false;
+			if (!bRegistered)
+			{
+				bRegistered = true;
+				UGameplayTagsManager::CallOrRegister_OnDoneAddingNativeTagsDelegate(FSimpleMulticastDelegate::FDelegate::CreateLambda([]()
+				{
+					bDoneAddingNativeTags = true;
+				}));
+			}
+			return bDoneAddingNativeTags;
+		}
+	}
+
+	FGameplayTagRegistrationBatch::FGameplayTagRegistrationBatch(const FString& InDevComment)
+		: DevComment(InDevComment)
+	{
+	}
+
+	void FGameplayTagRegistrationBatch::AddTag(FName TagName)
+	{
+		if (!TagName.IsNone())
+		{
+			TagNames.Add(TagName);
+		}
+	}
+
+	void FGameplayTagRegistrationBatch::AddCombinations(TConstArrayView<FName> ParentTagNames, TConstArrayView<FName> ChildNames)
+	{
+		TagNames.Reserve(TagNames.Num() + ParentTagNames.Num() * ChildNames.Num());
+		Combinations.Reserve(Combinations.Num() + ParentTagNames.Num() * ChildNames.Num());
+		for (const FName ParentTagName : ParentTagNames)
+		{
+			for (const FName ChildName : ChildNames)
+			{
+				TStringBuilder<256> CombinedName;
+				CombinedName << ParentTagName << TEXT('.') << ChildName;
+				const FName TagName(CombinedName.ToView());
+				TagNames.Add(TagName);
+				Combinations.Add(FCombination{ParentTagName, ChildName, TagName});
+			}
+		}
+	}
+
+	int32 FGameplayTagRegistrationBatch::Register()
+	{
+		check(IsInGameThread());
+		UGameplayTagsManager& Manager = UGameplayTagsManager::Get();
+		const bool bDoneAddingNativeTags = IsDoneAddingNativeTags();
+
+		TArray<FName> RegisteredTagNames;
+		// Listeners run once for the whole batch, the tag index only indexes the registered tags instead of the whole tree
+		FGameplayTagIndex& Index = FGameplayTagIndex::Get();
+		Index.BeginSourceUpdate();
+		Manager.PushDeferOnGameplayTagTreeChangedBroadcast();
+		for (const FName TagName : TagNames)
+		{
+			if (FGameplayTag::RequestGameplayTag(TagName, false).IsValid())
+			{
+				continue;
+			}
+			if (bDoneAddingNativeTags)
+			{
+				GeneratedNativeTags.Add(MakeUnique<FNativeGameplayTag>(UE_PLUGIN_NAME, UE_MODULE_NAME, TagName, DevComment, ENativeGameplayTagToken::PRIVATE_USE_MACRO_INSTEAD));
+			}
+			else
+			{
+				Manager.AddNativeGameplayTag(TagName, DevComment);
+			}
+			RegisteredTagNames.Add(TagName);
+		}
+		Manager.PopDeferOnGameplayTagTreeChangedBroadcast();
+		TArray<FGameplayTag> RegisteredTags;
+		RegisteredTags.Reserve(RegisteredTagNames.Num());
+		for (const FName TagName : RegisteredTagNames)
+		{
+			RegisteredTags.Add(FGameplayTag::RequestGameplayTag(TagName, false));
+		}
+		Index.EndSourceUpdate(RegisteredTags);
+		UE_LOG(LogHyphenUtil, Log, TEXT("Registered %d of %d generated gameplay tags"), RegisteredTagNames.Num(), TagNames.Num());
+
+		// Native tags added before done only exist once the engine builds the tree
+		UGameplayTagsManager::CallOrRegister_OnDoneAddingNativeTagsDelegate(FSimpleMulticastDelegate::FDelegate::CreateLambda([Combinations = MoveTemp(Combinations)]()
+		{
+			FGameplayTagCache& Cache = FGameplayTagCache::Get();
+			for (const FCombination& Combination : Combinations)
+			{
+				const FGameplayTag Tag = FGameplayTag::RequestGameplayTag(Combination.TagName, false);
+				if (Tag.IsValid())
+				{
+					Cache.AddCombined(Combination.ParentTagName, Combination.ChildName, Tag);
+				}
+			}
+		}));
+
+		TagNames.Reset();
+		Combinations.Reset();
+		return RegisteredTagNames.Num();
+	}
+
+	void ReleaseGeneratedGameplayTags()
+	{
+		GeneratedNativeTags.Empty();
+	}
+}
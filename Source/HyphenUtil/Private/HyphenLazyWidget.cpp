@@ -0,0 +1,138 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenLazyWidget.h"
+
+#include "Blueprint/UserWidget.h"
+#include "Containers/Ticker.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Layout/SBox.h"
+
+// Reports its first paint. Culled widgets are not painted, so this fires once the placeholder is actually on screen.
+class SHyphenLazyContent : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SHyphenLazyContent) {}
+		SLATE_ARGUMENT(FVector2D, PlaceholderSize)
+		SLATE_EVENT(FSimpleDelegate, OnFirstPaint)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs)
+	{
+		OnFirstPaint = InArgs._OnFirstPaint;
+		ChildSlot
+		[
+			SNew(SBox)
+			.MinDesiredWidth(InArgs._PlaceholderSize.X)
+			.MinDesiredHeight(InArgs._PlaceholderSize.Y)
+		];
+	}
+
+	void SetContent(const TSharedRef<SWidget>& Content)
+	{
+		bPainted = true;
+		ChildSlot
+		[
+			Content
+		];
+	}
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+	                      FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle,
+	                      bool bParentEnabled) const override
+	{
+		if (!bPainted)
+		{
+			// The hierarchy must not change while painting, the listener only queues the construction
+			bPainted = true;
+			OnFirstPaint.ExecuteIfBound();
+		}
+		return SCompoundWidget::OnPaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+	}
+
+private:
+	FSimpleDelegate OnFirstPaint;
+	mutable bool bPainted = false;
+};
+
+namespace HyphenLazyWidget
+{
+	static TAutoConsoleVariable<float> CVarLazyWidgetBudgetMs(
+		TEXT("HyphenUtil.LazyWidgetBudgetMs"),
+		2.f,
+		TEXT("Time spent constructing lazy widget contents per frame. At least one content is constructed each frame."));
+
+	TArray<TWeakObjectPtr<UHyphenLazyWidget>> PendingWidgets;
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	bool ConstructPendingWidgets(float DeltaTime)
+	{
+		const double EndTime = FPlatformTime::Seconds() + CVarLazyWidgetBudgetMs.GetValueOnGameThread() / 1000.0;
+		int32 NumProcessed = 0;
+		while (NumProcessed < PendingWidgets.Num() && (NumProcessed == 0 || FPlatformTime::Seconds() < EndTime))
+		{
+			if (UHyphenLazyWidget* Widget = PendingWidgets[NumProcessed].Get())
+			{
+				Widget->ConstructContentNow();
+			}
+			NumProcessed++;
+		}
+		PendingWidgets.RemoveAt(0, NumProcessed, false);
+
+		if (PendingWidgets.Num() == 0)
+		{
+			TickerHandle.Reset();
+			return false;
+		}
+		return true;
+	}
+}
+
+void UHyphenLazyWidget::ConstructContentNow()
+{
+	if (Content || !ContentClass)
+	{
+		return;
+	}
+	Content = CreateWidget(this, ContentClass);
+	if (Content && LazyContent.IsValid())
+	{
+		LazyContent->SetContent(Content->TakeWidget());
+	}
+	OnContentConstructed.Broadcast(Content);
+}
+
+void UHyphenLazyWidget::ReleaseSlateResources(bool bReleaseChildren)
+{
+	Super::ReleaseSlateResources(bReleaseChildren);
+	LazyContent.Reset();
+	if (Content && bReleaseChildren)
+	{
+		Content->ReleaseSlateResources(bReleaseChildren);
+	}
+}
+
+TSharedRef<SWidget> UHyphenLazyWidget::RebuildWidget()
+{
+	LazyContent = SNew(SHyphenLazyContent)
+		.PlaceholderSize(PlaceholderSize)
+		.OnFirstPaint(FSimpleDelegate::CreateUObject(this, &UHyphenLazyWidget::OnFirstPaint));
+	if (Content)
+	{
+		LazyContent->SetContent(Content->TakeWidget());
+	}
+	return LazyContent.ToSharedRef();
+}
+
+void UHyphenLazyWidget::OnFirstPaint()
+{
+	if (IsDesignTime())
+	{
+		return;
+	}
+	HyphenLazyWidget::PendingWidgets.Add(this);
+	if (!HyphenLazyWidget::TickerHandle.IsValid())
+	{
+		HyphenLazyWidget::TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&HyphenLazyWidget::ConstructPendingWidgets));
+	}
+}
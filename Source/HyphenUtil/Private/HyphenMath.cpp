@@ -0,0 +1,382 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenMath.h"
+
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeRWLock.h"
+
+namespace HyphenUtil
+{
+	namespace
+	{
+		// exp(X) for X <= 0, as 2^I * 2^F where X / ln(2) = I + F, with F in [-0.5, 0.5) and a degree five polynomial for 2^F.
+		FORCEINLINE VectorRegister4Float VectorExpFast(const VectorRegister4Float& X)
+		{
+			const VectorRegister4Float Exponent = VectorMultiply(X, VectorSetFloat1(1.44269504f));
+			const VectorRegister4Float IntegerPart = VectorFloor(VectorAdd(Exponent, VectorSetFloat1(0.5f)));
+			const VectorRegister4Float FractionPart = VectorSubtract(Exponent, IntegerPart);
+
+			// Taylor coefficients of 2^F, ln(2)^n / n!
+			VectorRegister4Float Polynomial = VectorSetFloat1(1.3333558e-3f);
+			Polynomial = VectorMultiplyAdd(Polynomial, FractionPart, VectorSetFloat1(9.6181291e-3f));
+			Polynomial = VectorMultiplyAdd(Polynomial, FractionPart, VectorSetFloat1(5.5504109e-2f));
+			Polynomial = VectorMultiplyAdd(Polynomial, FractionPart, VectorSetFloat1(2.4022651e-1f));
+			Polynomial = VectorMultiplyAdd(Polynomial, FractionPart, VectorSetFloat1(6.9314718e-1f));
+			Polynomial = VectorMultiplyAdd(Polynomial, FractionPart, VectorSetFloat1(1.f));
+
+			// 2^I built in the exponent bits, clamped to normal floats and flushed to zero below
+			const VectorRegister4Float ClampedIntegerPart = VectorMax(IntegerPart, VectorSetFloat1(-126.f));
+			const VectorRegister4Int ExponentBits = VectorShiftLeftImm(VectorIntAdd(VectorFloatToInt(ClampedIntegerPart), VectorIntSet1(127)), 23);
+			const VectorRegister4Float Result = VectorMultiply(Polynomial, VectorCast4IntTo4Float(ExponentBits));
+			return VectorSelect(VectorCompareLT(Exponent, VectorSetFloat1(-126.f)), VectorZeroFloat(), Result);
+		}
+
+		template <ENormalDistributionPrecision Precision>
+		FORCEINLINE VectorRegister4Float VectorNormalDistribution(const VectorRegister4Float& X, const VectorRegister4Float& Mean,
+		                                                          const VectorRegister4Float& Scale, const VectorRegister4Float& Coefficient)
+		{
+			const VectorRegister4Float Distance = VectorSubtract(X, Mean);
+			const VectorRegister4Float Exponent = VectorMultiply(VectorMultiply(Distance, Distance), Scale);
+			if constexpr (Precision == ENormalDistributionPrecision::Fast)
+			{
+				return VectorMultiply(Coefficient, VectorExpFast(Exponent));
+			}
+			else
+			{
+				return VectorMultiply(Coefficient, VectorExp(Exponent));
+			}
+		}
+
+		template <ENormalDistributionPrecision Precision>
+		void NormalDistributionBatch(float Mean, float StandardDeviation, float Coefficient, const float* X, float* OutValues, int32 Num)
+		{
+			const VectorRegister4Float MeanVector = VectorSetFloat1(Mean);
+			const VectorRegister4Float ScaleVector = VectorSetFloat1(-1.f / (2.f * StandardDeviation * StandardDeviation));
+			const VectorRegister4Float CoefficientVector = VectorSetFloat1(Coefficient);
+
+			int32 Index = 0;
+			for (; Index + 4 <= Num; Index += 4)
+			{
+				VectorStore(VectorNormalDistribution<Precision>(VectorLoad(X + Index), MeanVector, ScaleVector, CoefficientVector), OutValues + Index);
+			}
+			if (Index < Num)
+			{
+				// The remainder goes through the same math so every element has the same error
+				alignas(16) float Remainder[4] = {Mean, Mean, Mean, Mean};
+				FMemory::Memcpy(Remainder, X + Index, (Num - Index) * sizeof(float));
+				VectorStoreAligned(VectorNormalDistribution<Precision>(VectorLoadAligned(Remainder), MeanVector, ScaleVector, CoefficientVector), Remainder);
+				FMemory::Memcpy(OutValues + Index, Remainder, (Num - Index) * sizeof(float));
+			}
+		}
+
+		// Below this many cells the task overhead is larger than the convolution.
+		constexpr int32 MinParallelGridCells = 128 * 128;
+
+		EParallelForFlags GetGridParallelForFlags(int32 Width, int32 Height)
+		{
+			return Width * Height < MinParallelGridCells ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+		}
+
+		void ConvolveRow(const float* Input, float* Output, int32 Width, const float* Kernel, int32 Radius)
+		{
+			auto ConvolveClamped = [Input, Output, Width, Kernel, Radius](int32 X)
+			{
+				float Sum = 0.f;
+				for (int32 KernelIndex = 0; KernelIndex <= 2 * Radius; KernelIndex++)
+				{
+					Sum += Kernel[KernelIndex] * Input[FMath::Clamp(X + KernelIndex - Radius, 0, Width - 1)];
+				}
+				Output[X] = Sum;
+			};
+
+			int32 X = 0;
+			for (; X < FMath::Min(Radius, Width); X++)
+			{
+				ConvolveClamped(X);
+			}
+			// Four outputs at a time where the whole kernel is inside the row
+			for (; X + 4 <= Width - Radius; X += 4)
+			{
+				VectorRegister4Float Sum = VectorZeroFloat();
+				for (int32 KernelIndex = 0; KernelIndex <= 2 * Radius; KernelIndex++)
+				{
+					Sum = VectorMultiplyAdd(VectorLoad(Input + X + KernelIndex - Radius), VectorLoadFloat1(Kernel + KernelIndex), Sum);
+				}
+				VectorStore(Sum, Output + X);
+			}
+			for (; X < Width; X++)
+			{
+				ConvolveClamped(X);
+			}
+		}
+
+		// SplitMix64, used both to derive chunk streams from the seed and as the generator of each stream.
+		FORCEINLINE uint64 SplitMix64(uint64& State)
+		{
+			uint64 Value = (State += 0x9E3779B97F4A7C15ull);
+			Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+			Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+			return Value ^ (Value >> 31);
+		}
+
+		// Tables of the 128 layer ziggurat for the standard normal distribution, from Marsaglia and Tsang.
+		struct FZigguratTables
+		{
+			static constexpr double TailStart = 3.442619855899;
+			static constexpr double LayerArea = 9.91256303526217e-3;
+
+			uint32 Thresholds[128];
+			float Widths[128];
+			float Heights[128];
+
+			FZigguratTables()
+			{
+				constexpr double Scale = 2147483648.0;
+				double Edge = TailStart;
+				double PreviousEdge = TailStart;
+				const double BaseWidth = LayerArea / FMath::Exp(-0.5 * Edge * Edge);
+
+				Thresholds[0] = static_cast<uint32>(Edge / BaseWidth * Scale);
+				Thresholds[1] = 0;
+				Widths[0] = static_cast<float>(BaseWidth / Scale);
+				Widths[127] = static_cast<float>(Edge / Scale);
+				Heights[0] = 1.f;
+				Heights[127] = static_cast<float>(FMath::Exp(-0.5 * Edge * Edge));
+				for (int32 Layer = 126; Layer >= 1; Layer--)
+				{
+					Edge = FMath::Sqrt(-2.0 * FMath::Loge(LayerArea / Edge + FMath::Exp(-0.5 * Edge * Edge)));
+					Thresholds[Layer + 1] = static_cast<uint32>(Edge / PreviousEdge * Scale);
+					PreviousEdge = Edge;
+					Heights[Layer] = static_cast<float>(FMath::Exp(-0.5 * Edge * Edge));
+					Widths[Layer] = static_cast<float>(Edge / Scale);
+				}
+			}
+
+			static const FZigguratTables& Get()
+			{
+				static const FZigguratTables Tables;
+				return Tables;
+			}
+		};
+
+		// Uniform in (0, 1), never 0 so its log is finite.
+		FORCEINLINE float UniformOpen(uint64& State)
+		{
+			return (static_cast<float>(SplitMix64(State) >> 40) + 0.5f) * (1.f / 16777216.f);
+		}
+
+		// Standard normal value. Nearly every draw is accepted by the first comparison, the rest goes through the layer edges or the tail.
+		FORCEINLINE float ZigguratNormal(const FZigguratTables& Tables, uint64& State)
+		{
+			for (;;)
+			{
+				const int32 Bits = static_cast<int32>(static_cast<uint32>(SplitMix64(State)));
+				const int32 Layer = Bits & 127;
+				const uint32 AbsBits = Bits < 0 ? 0u - static_cast<uint32>(Bits) : static_cast<uint32>(Bits);
+				const float X = static_cast<float>(Bits) * Tables.Widths[Layer];
+				if (AbsBits < Tables.Thresholds[Layer])
+				{
+					return X;
+				}
+
+				if (Layer == 0)
+				{
+					// Tail beyond the base layer
+					float TailX;
+					float TailY;
+					do
+					{
+						TailX = -FMath::Loge(UniformOpen(State)) / static_cast<float>(FZigguratTables::TailStart);
+						TailY = -FMath::Loge(UniformOpen(State));
+					}
+					while (TailY + TailY < TailX * TailX);
+					return Bits > 0 ? static_cast<float>(FZigguratTables::TailStart) + TailX : -static_cast<float>(FZigguratTables::TailStart) - TailX;
+				}
+				if (Tables.Heights[Layer] + UniformOpen(State) * (Tables.Heights[Layer - 1] - Tables.Heights[Layer]) < FMath::Exp(-0.5f * X * X))
+				{
+					return X;
+				}
+			}
+		}
+	}
+
+	void NormalDistributionBatch(float Mean, float StandardDeviation, float Coefficient, TConstArrayView<float> X, TArrayView<float> OutValues,
+	                             ENormalDistributionPrecision Precision)
+	{
+		if (!ensureMsgf(X.Num() == OutValues.Num(), TEXT("NormalDistributionBatch got %d samples and %d outputs"), X.Num(), OutValues.Num()))
+		{
+			return;
+		}
+		if (StandardDeviation == 0.f)
+		{
+			// Degenerate distribution, keep the scalar results including NaN at the mean
+			for (int32 Index = 0; Index < X.Num(); Index++)
+			{
+				OutValues[Index] = Coefficient * FMath::Exp(-FMath::Pow(X[Index] - Mean, 2.f) / (2.f * FMath::Pow(StandardDeviation, 2.f)));
+			}
+			return;
+		}
+
+		if (Precision == ENormalDistributionPrecision::Fast)
+		{
+			NormalDistributionBatch<ENormalDistributionPrecision::Fast>(Mean, StandardDeviation, Coefficient, X.GetData(), OutValues.GetData(), X.Num());
+		}
+		else
+		{
+			NormalDistributionBatch<ENormalDistributionPrecision::Precise>(Mean, StandardDeviation, Coefficient, X.GetData(), OutValues.GetData(), X.Num());
+		}
+	}
+
+	FGaussianKernelRef GetGaussianKernel(float Sigma, int32 Radius)
+	{
+		static FRWLock Lock;
+		static TMap<TPair<int32, int32>, FGaussianKernelRef> Kernels;
+		// Keys in the order their kernels were built, the first one is dropped when the cache is full
+		static TArray<TPair<int32, int32>> BuildOrder;
+
+		if (!ensureMsgf(FMath::IsFinite(Sigma), TEXT("GetGaussianKernel got a sigma of %f"), Sigma))
+		{
+			Sigma = 0.f;
+		}
+		// Far wider than any radius, kept small enough to count its steps in an int32
+		constexpr float MaxSigma = 65536.f;
+		const int32 SigmaSteps = FMath::RoundToInt(FMath::Clamp(Sigma, 0.f, MaxSigma) / GaussianKernelSigmaStep);
+		Radius = FMath::Max(Radius, 0);
+		const TPair<int32, int32> Key(SigmaSteps, Radius);
+		{
+			FReadScopeLock ReadLock(Lock);
+			if (const FGaussianKernelRef* Kernel = Kernels.Find(Key))
+			{
+				return *Kernel;
+			}
+		}
+
+		TSharedRef<TArray<float>, ESPMode::ThreadSafe> NewKernel = MakeShared<TArray<float>, ESPMode::ThreadSafe>();
+		NewKernel->SetNumUninitialized(2 * Radius + 1);
+		if (SigmaSteps > 0)
+		{
+			for (int32 Index = 0; Index < NewKernel->Num(); Index++)
+			{
+				(*NewKernel)[Index] = static_cast<float>(Index - Radius);
+			}
+			NormalDistributionBatch(0.f, SigmaSteps * GaussianKernelSigmaStep, 1.f, *NewKernel, *NewKernel);
+			float Sum = 0.f;
+			for (const float Weight : *NewKernel)
+			{
+				Sum += Weight;
+			}
+			for (float& Weight : *NewKernel)
+			{
+				Weight /= Sum;
+			}
+		}
+		else
+		{
+			// No spread, the kernel keeps the grid as it is
+			FMemory::Memzero(NewKernel->GetData(), NewKernel->Num() * sizeof(float));
+			(*NewKernel)[Radius] = 1.f;
+		}
+
+		FWriteScopeLock WriteLock(Lock);
+		// Another thread may have built the same kernel meanwhile
+		if (const FGaussianKernelRef* Kernel = Kernels.Find(Key))
+		{
+			return *Kernel;
+		}
+		if (Kernels.Num() >= MaxCachedGaussianKernels)
+		{
+			Kernels.Remove(BuildOrder[0]);
+			BuildOrder.RemoveAt(0, 1, false);
+		}
+		BuildOrder.Add(Key);
+		return Kernels.Add(Key, NewKernel);
+	}
+
+	FGaussianKernel2D GetGaussianKernel2D(float SigmaX, float SigmaY, int32 RadiusX, int32 RadiusY)
+	{
+		return FGaussianKernel2D{GetGaussianKernel(SigmaX, RadiusX), GetGaussianKernel(SigmaY, RadiusY)};
+	}
+
+	void GaussianBlur(TConstArrayView<float> Grid, int32 Width, int32 Height, float Sigma, int32 Radius, TArrayView<float> OutGrid, TArray<float>& Scratch)
+	{
+		GaussianBlur(Grid, Width, Height, GetGaussianKernel2D(Sigma, Sigma, Radius, Radius), OutGrid, Scratch);
+	}
+
+	void GaussianBlur(TConstArrayView<float> Grid, int32 Width, int32 Height, const FGaussianKernel2D& Kernel, TArrayView<float> OutGrid, TArray<float>& Scratch)
+	{
+		Scratch.SetNumUninitialized(Width * Height, false);
+		ConvolveRows(Grid, Width, Height, *Kernel.Rows, Scratch);
+		ConvolveColumns(Scratch, Width, Height, *Kernel.Columns, OutGrid);
+	}
+
+	void ConvolveRows(TConstArrayView<float> Grid, int32 Width, int32 Height, TConstArrayView<float> Kernel, TArrayView<float> OutGrid)
+	{
+		if (!ensureMsgf(Grid.Num() == Width * Height && OutGrid.Num() == Width * Height && Kernel.Num() % 2 == 1,
+		                TEXT("ConvolveRows got %d cells and %d outputs for %dx%d, and %d weights"), Grid.Num(), OutGrid.Num(), Width, Height, Kernel.Num()))
+		{
+			return;
+		}
+
+		const int32 Radius = Kernel.Num() / 2;
+		ParallelFor(Height, [&Grid, &OutGrid, &Kernel, Width, Radius](int32 Y)
+		{
+			ConvolveRow(Grid.GetData() + Y * Width, OutGrid.GetData() + Y * Width, Width, Kernel.GetData(), Radius);
+		}, GetGridParallelForFlags(Width, Height));
+	}
+
+	void ConvolveColumns(TConstArrayView<float> Grid, int32 Width, int32 Height, TConstArrayView<float> Kernel, TArrayView<float> OutGrid)
+	{
+		if (!ensureMsgf(Grid.Num() == Width * Height && OutGrid.Num() == Width * Height && Kernel.Num() % 2 == 1,
+		                TEXT("ConvolveColumns got %d cells and %d outputs for %dx%d, and %d weights"), Grid.Num(), OutGrid.Num(), Width, Height, Kernel.Num()))
+		{
+			return;
+		}
+
+		// Each output row is a weighted sum of whole input rows, so the columns are vectorized four at a time
+		const int32 Radius = Kernel.Num() / 2;
+		ParallelFor(Height, [&Grid, &OutGrid, &Kernel, Width, Height, Radius](int32 Y)
+		{
+			float* Output = OutGrid.GetData() + Y * Width;
+			int32 X = 0;
+			for (; X + 4 <= Width; X += 4)
+			{
+				VectorRegister4Float Sum = VectorZeroFloat();
+				for (int32 KernelIndex = 0; KernelIndex < Kernel.Num(); KernelIndex++)
+				{
+					const int32 SourceY = FMath::Clamp(Y + KernelIndex - Radius, 0, Height - 1);
+					Sum = VectorMultiplyAdd(VectorLoad(Grid.GetData() + SourceY * Width + X), VectorLoadFloat1(&Kernel[KernelIndex]), Sum);
+				}
+				VectorStore(Sum, Output + X);
+			}
+			for (; X < Width; X++)
+			{
+				float Sum = 0.f;
+				for (int32 KernelIndex = 0; KernelIndex < Kernel.Num(); KernelIndex++)
+				{
+					Sum += Kernel[KernelIndex] * Grid[FMath::Clamp(Y + KernelIndex - Radius, 0, Height - 1) * Width + X];
+				}
+				Output[X] = Sum;
+			}
+		}, GetGridParallelForFlags(Width, Height));
+	}
+
+	void GaussianRandomBatch(int32 Seed, float Mean, float StandardDeviation, TArrayView<float> OutValues, EParallelForFlags Flags)
+	{
+		const FZigguratTables& Tables = FZigguratTables::Get();
+		const int32 NumChunks = FMath::DivideAndRoundUp(OutValues.Num(), GaussianRandomChunkSize);
+		ParallelFor(NumChunks, [&Tables, &OutValues, Seed, Mean, StandardDeviation](int32 ChunkIndex)
+		{
+			// The stream of a chunk only depends on the seed and the chunk index
+			uint64 SeedState = static_cast<uint64>(static_cast<uint32>(Seed)) ^ (static_cast<uint64>(ChunkIndex) << 32);
+			uint64 State = SplitMix64(SeedState);
+
+			const int32 Start = ChunkIndex * GaussianRandomChunkSize;
+			const int32 End = FMath::Min(Start + GaussianRandomChunkSize, OutValues.Num());
+			for (int32 Index = Start; Index < End; Index++)
+			{
+				OutValues[Index] = Mean + StandardDeviation * ZigguratNormal(Tables, State);
+			}
+		}, NumChunks > 1 ? Flags : EParallelForFlags::ForceSingleThread);
+	}
+}
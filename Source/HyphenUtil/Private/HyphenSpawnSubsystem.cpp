@@ -0,0 +1,147 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenSpawnSubsystem.h"
+
+#include "HyphenAssetManager.h"
+#include "HyphenUtilLogs.h"
+#include "Engine/Engine.h"
+#include "Kismet/GameplayStatics.h"
+
+void FHyphenSpawnBatch::Cancel()
+{
+	if (bComplete)
+	{
+		return;
+	}
+	if (!bLoaded && LoadHandle.IsValid())
+	{
+		LoadHandle->CancelHandle();
+	}
+	NextRequest = Requests.Num();
+	Complete();
+}
+
+void FHyphenSpawnBatch::Complete()
+{
+	bComplete = true;
+	LoadHandle.Reset();
+	OnComplete.Broadcast();
+}
+
+UHyphenSpawnSubsystem* UHyphenSpawnSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	return World ? World->GetSubsystem<UHyphenSpawnSubsystem>() : nullptr;
+}
+
+TSharedRef<FHyphenSpawnBatch> UHyphenSpawnSubsystem::SpawnActorsAsync(const TArray<FHyphenSpawnRequest>& Requests, FName ReferenceAssetTag,
+                                                                      TAsyncLoadPriority Priority, AActor* Owner,
+                                                                      ESpawnActorCollisionHandlingMethod CollisionHandling)
+{
+	TSharedRef<FHyphenSpawnBatch> Batch = MakeShared<FHyphenSpawnBatch>();
+	Batch->Requests = Requests;
+	Batch->Owner = Owner;
+	Batch->CollisionHandling = CollisionHandling;
+	Batch->SpawnedActors.Reserve(Requests.Num());
+	Batches.Add(Batch);
+
+	// Requests share classes, RequestAsyncLoad removes the duplicates
+	TArray<FSoftObjectPath> ClassPaths;
+	ClassPaths.Reserve(Requests.Num());
+	for (const FHyphenSpawnRequest& Request : Requests)
+	{
+		ClassPaths.Add(Request.ActorClass.ToSoftObjectPath());
+	}
+
+	Batch->LoadHandle = UHyphenAssetManager::RequestAsyncLoad(ClassPaths, ReferenceAssetTag,
+	                                                          FStreamableDelegate::CreateUObject(this, &UHyphenSpawnSubsystem::OnBatchLoaded, TWeakPtr<FHyphenSpawnBatch>(Batch)),
+	                                                          Priority, false, false, TEXT("HyphenSpawnBatch"));
+	if (!Batch->LoadHandle.IsValid())
+	{
+		// Nothing to load, every request either is loaded already or has no class
+		Batch->bLoaded = true;
+	}
+	return Batch;
+}
+
+void UHyphenSpawnSubsystem::OnBatchLoaded(TWeakPtr<FHyphenSpawnBatch> WeakBatch)
+{
+	if (const TSharedPtr<FHyphenSpawnBatch> Batch = WeakBatch.Pin())
+	{
+		Batch->bLoaded = true;
+	}
+}
+
+void UHyphenSpawnSubsystem::Tick(float DeltaTime)
+{
+	if (Batches.Num() == 0)
+	{
+		return;
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + SpawnBudgetMs / 1000.0;
+	// Failed spawns cost time too, the budget counts attempts so a batch of failing requests cannot stall the frame
+	bool bAttemptedAny = false;
+	for (int32 BatchIndex = 0; BatchIndex < Batches.Num(); BatchIndex++)
+	{
+		const TSharedRef<FHyphenSpawnBatch> Batch = Batches[BatchIndex];
+		// Batches still loading do not hold up the ones behind them
+		while (!Batch->bComplete && Batch->bLoaded)
+		{
+			// Also completes empty batches, a frame after they were started so callers had a chance to bind OnComplete
+			if (Batch->NextRequest >= Batch->Requests.Num())
+			{
+				Batch->Complete();
+				break;
+			}
+			if (bAttemptedAny && FPlatformTime::Seconds() >= EndTime)
+			{
+				break;
+			}
+			SpawnNext(*Batch);
+			bAttemptedAny = true;
+		}
+		if (bAttemptedAny && FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+	}
+
+	Batches.RemoveAll([](const TSharedRef<FHyphenSpawnBatch>& Batch) { return Batch->bComplete; });
+}
+
+void UHyphenSpawnSubsystem::SpawnNext(FHyphenSpawnBatch& Batch)
+{
+	const FHyphenSpawnRequest& Request = Batch.Requests[Batch.NextRequest++];
+	UClass* ActorClass = Request.ActorClass.Get();
+	AActor* Actor = ActorClass ? UGameplayStatics::BeginDeferredActorSpawnFromClass(GetWorld(), ActorClass, Request.Transform, Batch.CollisionHandling, Batch.Owner.Get()) : nullptr;
+	if (!IsValid(Actor))
+	{
+		UE_LOG(LogHyphenUtil, Warning, TEXT("Failed to spawn actor of class [%s]"), *Request.ActorClass.ToString());
+		Batch.NumFailed++;
+		return;
+	}
+
+	Batch.OnActorDeferredSpawn.Broadcast(Actor);
+	UGameplayStatics::FinishSpawningActor(Actor, Request.Transform);
+	Batch.SpawnedActors.Add(Actor);
+	Batch.OnActorSpawned.Broadcast(Actor);
+}
+
+TStatId UHyphenSpawnSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHyphenSpawnSubsystem, STATGROUP_Tickables);
+}
+
+void UHyphenSpawnSubsystem::Deinitialize()
+{
+	// Copy, cancel callbacks may start new batches
+	const TArray<TSharedRef<FHyphenSpawnBatch>> PendingBatches = MoveTemp(Batches);
+	Batches.Reset();
+	for (const TSharedRef<FHyphenSpawnBatch>& Batch : PendingBatches)
+	{
+		Batch->Cancel();
+	}
+	Super::Deinitialize();
+}
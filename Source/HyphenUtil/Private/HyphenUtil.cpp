@@ -2,19 +2,47 @@
 
 #include "HyphenUtil.h"
 
+#include "GameplayTagsManager.h"
+#include "GameplayTagsModule.h"
+#include "HyphenAssetManager.h"
+#include "HyphenGameplayTagCache.h"
+#include "HyphenGameplayTagRegistration.h"
+#include "Engine/Engine.h"
+
 #define LOCTEXT_NAMESPACE "FHyphenUtilModule"
 
 void FHyphenUtilModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
-	
+
+	// Start the warm-up preload as soon as the asset manager exists so boot I/O overlaps engine initialization
+	UAssetManager::CallOrRegister_OnAssetManagerCreated(FSimpleMulticastDelegate::FDelegate::CreateLambda([]()
+	{
+		if (UHyphenAssetManager* AssetManager = Cast<UHyphenAssetManager>(GEngine ? GEngine->AssetManager : nullptr))
+		{
+			AssetManager->StartWarmUp();
+		}
+	}));
+
+	// Combined tags may resolve differently once tags are added or removed
+	UGameplayTagsManager::CallOrRegister_OnDoneAddingNativeTagsDelegate(FSimpleMulticastDelegate::FDelegate::CreateLambda([]()
+	{
+		HyphenUtil::FGameplayTagIndex::Get().Update();
+	}));
+	GameplayTagTreeChangedHandle = IGameplayTagsModule::OnGameplayTagTreeChanged.AddLambda([]()
+	{
+		HyphenUtil::FGameplayTagCache::Get().Invalidate();
+		HyphenUtil::FGameplayTagIndex::Get().Update();
+	});
 }
 
 void FHyphenUtilModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
-	
+	IGameplayTagsModule::OnGameplayTagTreeChanged.Remove(GameplayTagTreeChangedHandle);
+	HyphenUtil::ReleaseGeneratedGameplayTags();
+	HyphenUtil::FGameplayTagIndex::Get().Reset();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,890 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "GameplayTagsManager.h"
+#include "HyphenAssetManager.h"
+#include "HyphenGameplayTagBatch.h"
+#include "HyphenGameplayTagBitset.h"
+#include "HyphenGameplayTagCache.h"
+#include "HyphenMath.h"
+#include "HyphenUtilLibrary.h"
+#include "HyphenUtilLogs.h"
+#include "Async/ParallelFor.h"
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Curves/CurveFloat.h"
+#include "Dom/JsonObject.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/GCObject.h"
+#include "UObject/Package.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace HyphenUtilBenchmarks
+{
+	template <typename ValueType>
+	ValueType GetArg(const TArray<FString>& Args, int32 Index, ValueType DefaultValue)
+	{
+		ValueType Value = DefaultValue;
+		if (Args.IsValidIndex(Index))
+		{
+			LexFromString(Value, *Args[Index]);
+		}
+		return Value;
+	}
+
+	// Returns the average milliseconds of a full purge GC.
+	double MeasureGarbageCollection(int32 Iterations)
+	{
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; i++)
+		{
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0 / FMath::Max(Iterations, 1);
+	}
+
+	// Synthetic assets, small transient objects outside of any package on disk.
+	TArray<UObject*> CreateSyntheticAssets(int32 NumAssets)
+	{
+		TArray<UObject*> Assets;
+		Assets.Reserve(NumAssets);
+		for (int32 i = 0; i < NumAssets; i++)
+		{
+			Assets.Add(NewObject<UCurveFloat>(GetTransientPackage(), NAME_None, RF_Transient));
+		}
+		return Assets;
+	}
+
+	// On-disk assets under PackagePath that are not loaded yet, so requests go through the loader instead of resolving in memory.
+	TArray<FSoftObjectPath> GatherUnloadedAssetPaths(const FString& PackagePath, int32 MaxPaths)
+	{
+		FARFilter Filter;
+		Filter.PackagePaths.Add(FName(PackagePath));
+		Filter.bRecursivePaths = true;
+		TArray<FAssetData> AssetDatas;
+		UAssetManager::GetAssetRegistry().GetAssets(Filter, AssetDatas);
+
+		TArray<FSoftObjectPath> Paths;
+		for (const FAssetData& AssetData : AssetDatas)
+		{
+			if (Paths.Num() >= MaxPaths)
+			{
+				break;
+			}
+			if (!AssetData.IsAssetLoaded() && !AssetData.IsRedirector())
+			{
+				Paths.Add(AssetData.GetSoftObjectPath());
+			}
+		}
+		return Paths;
+	}
+
+	// GC time with synthetic objects held under reference tags by UHyphenAssetManager, i.e. reported from its ReferenceObjectPool.
+	void BenchmarkReferenceGC(const TArray<FString>& Args)
+	{
+		const int32 NumObjects = GetArg(Args, 0, 100000);
+		const int32 NumTags = FMath::Max(GetArg(Args, 1, 1000), 1);
+		const int32 Iterations = GetArg(Args, 2, 5);
+
+		const double BaselineMs = MeasureGarbageCollection(Iterations);
+
+		TArray<UObject*> Objects = CreateSyntheticAssets(NumObjects);
+		const double HoldStartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumObjects; i++)
+		{
+			// Already in memory, so GetAsset only adds the object to the reference pool of the tag
+			UHyphenAssetManager::GetAsset(TSoftObjectPtr<UCurveFloat>(CastChecked<UCurveFloat>(Objects[i])), FName(TEXT("HyphenBench.ReferenceGC"), i % NumTags));
+		}
+		const double HoldMs = (FPlatformTime::Seconds() - HoldStartTime) * 1000.0;
+		// Only the asset manager keeps them alive from here on
+		Objects.Empty();
+
+		const double HeldMs = MeasureGarbageCollection(Iterations);
+
+		const double FlushStartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumTags; i++)
+		{
+			UHyphenAssetManager::FlushReferenceLoadedAssets(FName(TEXT("HyphenBench.ReferenceGC"), i));
+		}
+		const double FlushMs = (FPlatformTime::Seconds() - FlushStartTime) * 1000.0;
+		const double FlushedMs = MeasureGarbageCollection(Iterations);
+
+		UE_LOG(LogHyphenUtil, Display, TEXT("ReferenceGC %d objects / %d tags: baseline %.3f ms, held %.3f ms (+%.3f), after flush %.3f ms. Holding took %.3f ms, flushing %.3f ms"),
+		       NumObjects, NumTags, BaselineMs, HeldMs, HeldMs - BaselineMs, FlushedMs, HoldMs, FlushMs);
+	}
+
+	struct FBenchmarkResult
+	{
+		FString Name;
+		int32 Iterations = 0;
+		double TotalMs = 0.0;
+		uint64 Allocations = 0;
+	};
+
+	uint64 GetTotalMallocCalls()
+	{
+		return FMalloc::TotalMallocCalls.load(std::memory_order_relaxed);
+	}
+
+	// Times one call of Function and counts the allocations made meanwhile on all threads.
+	template <typename FunctionType>
+	FBenchmarkResult Measure(const TCHAR* Name, int32 Iterations, FunctionType&& Function)
+	{
+		FBenchmarkResult Result;
+		Result.Name = Name;
+		Result.Iterations = Iterations;
+		const uint64 StartMallocCalls = GetTotalMallocCalls();
+		const double StartTime = FPlatformTime::Seconds();
+		Function();
+		Result.TotalMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		Result.Allocations = GetTotalMallocCalls() - StartMallocCalls;
+		return Result;
+	}
+
+	// Writes results to Saved/Benchmarks/<BenchmarkName>-<timestamp>.json and returns the file path.
+	FString WriteResults(const FString& BenchmarkName, const TSharedRef<FJsonObject>& Parameters, const TArray<FBenchmarkResult>& Results)
+	{
+		TArray<TSharedPtr<FJsonValue>> ResultValues;
+		for (const FBenchmarkResult& Result : Results)
+		{
+			const TSharedRef<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+			ResultObject->SetStringField(TEXT("Name"), Result.Name);
+			ResultObject->SetNumberField(TEXT("Iterations"), Result.Iterations);
+			ResultObject->SetNumberField(TEXT("TotalMs"), Result.TotalMs);
+			ResultObject->SetNumberField(TEXT("PerIterationUs"), Result.TotalMs * 1000.0 / FMath::Max(Result.Iterations, 1));
+			ResultObject->SetNumberField(TEXT("Allocations"), static_cast<double>(Result.Allocations));
+			ResultObject->SetNumberField(TEXT("AllocationsPerIteration"), static_cast<double>(Result.Allocations) / FMath::Max(Result.Iterations, 1));
+			ResultValues.Add(MakeShared<FJsonValueObject>(ResultObject));
+
+			UE_LOG(LogHyphenUtil, Display, TEXT("%s.%s: %d iterations, %.3f ms, %llu allocations"), *BenchmarkName, *Result.Name,
+			       Result.Iterations, Result.TotalMs, Result.Allocations);
+		}
+
+		const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetStringField(TEXT("Benchmark"), BenchmarkName);
+		Root->SetStringField(TEXT("Timestamp"), FDateTime::UtcNow().ToIso8601());
+		Root->SetObjectField(TEXT("Parameters"), Parameters);
+		Root->SetArrayField(TEXT("Results"), ResultValues);
+
+		FString Json;
+		FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Json));
+		const FString ResultPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("%s-%s.json"), *BenchmarkName, *FDateTime::Now().ToString());
+		FFileHelper::SaveStringToFile(Json, *ResultPath);
+		UE_LOG(LogHyphenUtil, Display, TEXT("Benchmark results written to %s"), *ResultPath);
+		return ResultPath;
+	}
+
+	/**
+	 * Exercises UHyphenAssetManager with unloaded on-disk assets over several frames, so loads and completions go through the
+	 * async loader the way they do in game. Only touches its own HyphenBench.* tags, the rest of the asset manager state is left alone.
+	 */
+	class FAssetManagerBenchmark : public FGCObject
+	{
+	public:
+		FAssetManagerBenchmark(TArray<FSoftObjectPath>&& InPaths, int32 InCyclesPerFrame, int32 InNumFrames, int32 InNumFlushCycles)
+			: NumPaths(InPaths.Num()), CyclesPerFrame(InCyclesPerFrame), NumFrames(InNumFrames), NumFlushCycles(InNumFlushCycles), Paths(MoveTemp(InPaths))
+		{
+			for (int32 i = 0; i < NumHoldTags; i++)
+			{
+				HoldTags.Add(FName(TEXT("HyphenBench.Hold"), i));
+			}
+		}
+
+		// Returns false once every step has run and the results are written.
+		bool Tick()
+		{
+			switch (Step)
+			{
+			case EStep::Request:
+				StepStartTime = FPlatformTime::Seconds();
+				Results.Add(Measure(TEXT("RequestAsyncLoad"), NumPaths, [this]()
+				{
+					RequestHandle = UHyphenAssetManager::RequestAsyncLoad(Paths, RequestTag);
+				}));
+				Step = EStep::RequestWait;
+				break;
+
+			case EStep::RequestWait:
+				if (IsTagLoaded(RequestTag))
+				{
+					FBenchmarkResult& Latency = Results.AddDefaulted_GetRef();
+					Latency.Name = TEXT("RequestAsyncLoadLatency");
+					Latency.Iterations = NumPaths;
+					Latency.TotalMs = (FPlatformTime::Seconds() - StepStartTime) * 1000.0;
+					// Kept alive for the loaded asset list step, the tag itself is flushed right away
+					RequestHandle->GetLoadedAssets(Assets);
+					RequestHandle.Reset();
+					UHyphenAssetManager::FlushReferenceLoadedAssets(RequestTag);
+					Step = EStep::HoldRelease;
+				}
+				break;
+
+			case EStep::HoldRelease:
+			{
+				// A base hold per tag keeps the counters above zero, this measures the bookkeeping only
+				if (Frame == 0)
+				{
+					for (const FName HoldTag : HoldTags)
+					{
+						UHyphenAssetManager::HoldAssetReference(HoldTag);
+					}
+				}
+				FBenchmarkResult Result = Measure(TEXT("HoldRelease"), CyclesPerFrame, [this]()
+				{
+					for (int32 i = 0; i < CyclesPerFrame; i++)
+					{
+						const FName HoldTag = HoldTags[i % NumHoldTags];
+						UHyphenAssetManager::HoldAssetReference(HoldTag);
+						UHyphenAssetManager::ReleaseAssetReference(HoldTag);
+					}
+				});
+				AccumulateResult(MoveTemp(Result));
+				if (++Frame >= NumFrames)
+				{
+					for (const FName HoldTag : HoldTags)
+					{
+						UHyphenAssetManager::ReleaseAssetReference(HoldTag);
+					}
+					Frame = 0;
+					Step = EStep::ConcurrentAddLoadedAsset;
+				}
+				break;
+			}
+
+			case EStep::ConcurrentAddLoadedAsset:
+			{
+				UHyphenAssetManager& AssetManager = UHyphenAssetManager::Get();
+				Results.Add(Measure(TEXT("ConcurrentAddLoadedAsset"), Assets.Num(), [this, &AssetManager]()
+				{
+					ParallelFor(Assets.Num(), [this, &AssetManager](int32 i)
+					{
+						AssetManager.AddLoadedAsset(Assets[i]);
+					});
+				}));
+				Results.Add(Measure(TEXT("ReleaseLoadedAsset"), Assets.Num(), [this, &AssetManager]()
+				{
+					for (const UObject* Asset : Assets)
+					{
+						AssetManager.ReleaseLoadedAsset(Asset);
+					}
+				}));
+				// Unload again, every flush cycle loads the assets from disk
+				Assets.Reset();
+				CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+				Step = EStep::FlushRequest;
+				break;
+			}
+
+			case EStep::FlushRequest:
+				// The previous cycle's flush and GC unloaded the assets, only the flushed tag holds them once loaded
+				RequestHandle = UHyphenAssetManager::RequestAsyncLoad(Paths, FlushTag);
+				Step = EStep::FlushWait;
+				break;
+
+			case EStep::FlushWait:
+				if (IsTagLoaded(FlushTag))
+				{
+					RequestHandle.Reset();
+					AccumulateResult(Measure(TEXT("Flush"), 1, [this]()
+					{
+						UHyphenAssetManager::FlushReferenceLoadedAssets(FlushTag);
+					}));
+					AccumulateResult(Measure(TEXT("FlushGC"), 1, []()
+					{
+						CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+					}));
+					Step = ++Frame < NumFlushCycles ? EStep::FlushRequest : EStep::Finish;
+				}
+				break;
+
+			case EStep::Finish:
+			{
+				const TSharedRef<FJsonObject> Parameters = MakeShared<FJsonObject>();
+				Parameters->SetNumberField(TEXT("NumPaths"), NumPaths);
+				Parameters->SetNumberField(TEXT("CyclesPerFrame"), CyclesPerFrame);
+				Parameters->SetNumberField(TEXT("NumFrames"), NumFrames);
+				Parameters->SetNumberField(TEXT("NumFlushCycles"), NumFlushCycles);
+				WriteResults(TEXT("HyphenAssetManager"), Parameters, Results);
+				return false;
+			}
+			}
+			return true;
+		}
+
+		virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+		{
+			Collector.AddReferencedObjects(Assets);
+		}
+		virtual FString GetReferencerName() const override { return TEXT("HyphenUtilBenchmarks::FAssetManagerBenchmark"); }
+
+	private:
+		enum class EStep : uint8
+		{
+			Request,
+			RequestWait,
+			HoldRelease,
+			ConcurrentAddLoadedAsset,
+			FlushRequest,
+			FlushWait,
+			Finish,
+		};
+
+		static constexpr int32 NumHoldTags = 64;
+
+		static bool IsTagLoaded(FName AssetTag)
+		{
+			const FHyphenTagLoadProgress* Progress = UHyphenAssetManager::FindTagLoadProgress(AssetTag);
+			return Progress == nullptr || Progress->IsComplete();
+		}
+
+		// Frame-by-frame steps add up into a single result per name.
+		void AccumulateResult(FBenchmarkResult&& Result)
+		{
+			if (FBenchmarkResult* Existing = Results.FindByPredicate([&Result](const FBenchmarkResult& Other) { return Other.Name == Result.Name; }))
+			{
+				Existing->Iterations += Result.Iterations;
+				Existing->TotalMs += Result.TotalMs;
+				Existing->Allocations += Result.Allocations;
+			}
+			else
+			{
+				Results.Add(MoveTemp(Result));
+			}
+		}
+
+		const int32 NumPaths;
+		const int32 CyclesPerFrame;
+		const int32 NumFrames;
+		const int32 NumFlushCycles;
+
+		TArray<FSoftObjectPath> Paths;
+		// Objects of the first request, kept between the request and the loaded asset list step.
+		TArray<UObject*> Assets;
+		TArray<FName> HoldTags;
+		const FName RequestTag = TEXT("HyphenBench.Request");
+		const FName FlushTag = TEXT("HyphenBench.Flush");
+		TSharedPtr<FStreamableHandle> RequestHandle;
+
+		EStep Step = EStep::Request;
+		int32 Frame = 0;
+		double StepStartTime = 0.0;
+		TArray<FBenchmarkResult> Results;
+	};
+
+	TUniquePtr<FAssetManagerBenchmark> ActiveAssetManagerBenchmark;
+
+	void BenchmarkAssetManager(const TArray<FString>& Args)
+	{
+		if (ActiveAssetManagerBenchmark.IsValid())
+		{
+			UE_LOG(LogHyphenUtil, Warning, TEXT("HyphenUtil.Bench.AssetManager is already running"));
+			return;
+		}
+		const FString PackagePath = GetArg(Args, 4, FString(TEXT("/Engine")));
+		TArray<FSoftObjectPath> Paths = GatherUnloadedAssetPaths(PackagePath, FMath::Max(GetArg(Args, 0, 10000), 1));
+		if (Paths.Num() == 0)
+		{
+			UE_LOG(LogHyphenUtil, Warning, TEXT("HyphenUtil.Bench.AssetManager found no unloaded assets under %s"), *PackagePath);
+			return;
+		}
+		ActiveAssetManagerBenchmark = MakeUnique<FAssetManagerBenchmark>(MoveTemp(Paths), FMath::Max(GetArg(Args, 1, 5000), 1),
+		                                                                 FMath::Max(GetArg(Args, 2, 10), 1), FMath::Max(GetArg(Args, 3, 10), 1));
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](float)
+		{
+			if (ActiveAssetManagerBenchmark->Tick())
+			{
+				return true;
+			}
+			ActiveAssetManagerBenchmark.Reset();
+			return false;
+		}));
+	}
+
+	void BenchmarkGameplayTags(const TArray<FString>& Args)
+	{
+		const int32 Iterations = FMath::Max(GetArg(Args, 0, 100000), 1);
+
+		// Any registered tag with a parent works, the helpers only need names that resolve
+		FGameplayTagContainer AllTags;
+		UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, false);
+		FGameplayTag Tag;
+		FGameplayTag ParentTag;
+		for (const FGameplayTag& Candidate : AllTags)
+		{
+			ParentTag = Candidate.RequestDirectParent();
+			if (ParentTag.IsValid())
+			{
+				Tag = Candidate;
+				break;
+			}
+		}
+		if (!Tag.IsValid())
+		{
+			UE_LOG(LogHyphenUtil, Warning, TEXT("HyphenUtil.Bench.GameplayTags needs at least one registered tag with a parent"));
+			return;
+		}
+
+		const FString TagString = Tag.ToString();
+		const FString ParentString = ParentTag.ToString();
+		const FString ChildString = TagString.RightChop(ParentString.Len() + 1);
+		const FStringView TagView = TagString;
+		const FStringView ParentView = ParentString;
+		const FStringView ChildView = ChildString;
+
+		// Fill the combination cache before measuring
+		HyphenUtil::CombineGameplayTagWithString(ParentTag, ChildView);
+		HyphenUtil::CombineGameplayTagWithString(ParentView, ChildView);
+
+		int32 NumMismatches = 0;
+		TArray<FBenchmarkResult> Results;
+		Results.Add(Measure(TEXT("StringCopyBaseline"), Iterations, [&]()
+		{
+			for (int32 i = 0; i < Iterations; i++)
+			{
+				FString CleanTagName = ParentString;
+				CleanTagName.RemoveSpacesInline();
+				NumMismatches += FGameplayTag::RequestGameplayTag(*FString::Printf(TEXT("%s.%s"), *CleanTagName, *ChildString)) != Tag;
+			}
+		}));
+		Results.Add(Measure(TEXT("GetGameplayTagFromString"), Iterations, [&]()
+		{
+			for (int32 i = 0; i < Iterations; i++)
+			{
+				NumMismatches += HyphenUtil::GetGameplayTagFromString(TagView) != Tag;
+			}
+		}));
+		Results.Add(Measure(TEXT("CombineGameplayTagWithString.Tag"), Iterations, [&]()
+		{
+			for (int32 i = 0; i < Iterations; i++)
+			{
+				NumMismatches += HyphenUtil::CombineGameplayTagWithString(ParentTag, ChildView) != Tag;
+			}
+		}));
+		Results.Add(Measure(TEXT("CombineGameplayTagWithString.String"), Iterations, [&]()
+		{
+			for (int32 i = 0; i < Iterations; i++)
+			{
+				NumMismatches += HyphenUtil::CombineGameplayTagWithString(ParentView, ChildView) != Tag;
+			}
+		}));
+		Results.Add(Measure(TEXT("TryCombineGameplayTagWithString"), Iterations, [&]()
+		{
+			FGameplayTag CombinedTag;
+			for (int32 i = 0; i < Iterations; i++)
+			{
+				NumMismatches += !HyphenUtil::TryCombineGameplayTagWithString(ParentView, ChildView, CombinedTag) || CombinedTag != Tag;
+			}
+		}));
+		ensureMsgf(NumMismatches == 0, TEXT("%d tag helper calls did not resolve [%s]"), NumMismatches, *TagString);
+
+		const TSharedRef<FJsonObject> Parameters = MakeShared<FJsonObject>();
+		Parameters->SetNumberField(TEXT("Iterations"), Iterations);
+		Parameters->SetStringField(TEXT("Tag"), TagString);
+		WriteResults(TEXT("GameplayTags"), Parameters, Results);
+	}
+
+	void BenchmarkGameplayTagImport(const TArray<FString>& Args)
+	{
+		const int32 NumStrings = FMath::Max(GetArg(Args, 0, 50000), 1);
+
+		FGameplayTagContainer AllTags;
+		UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, false);
+		if (AllTags.Num() == 0)
+		{
+			UE_LOG(LogHyphenUtil, Warning, TEXT("HyphenUtil.Bench.GameplayTagImport needs at least one registered tag"));
+			return;
+		}
+
+		// Repeated tags like an imported table, some padded the way spreadsheet cells often are
+		TArray<FString> TagStrings;
+		TagStrings.Reserve(NumStrings);
+		for (int32 i = 0; i < NumStrings; i++)
+		{
+			const FString TagString = AllTags.GetByIndex(i % AllTags.Num()).ToString();
+			TagStrings.Add(i % 4 == 0 ? FString::Printf(TEXT(" %s "), *TagString) : TagString);
+		}
+
+		TArray<FGameplayTag> SequentialTags;
+		SequentialTags.Reserve(NumStrings);
+		HyphenUtil::FGameplayTagBatchResult BatchResult;
+		TArray<FBenchmarkResult> Results;
+		Results.Add(Measure(TEXT("Sequential"), NumStrings, [&]()
+		{
+			for (const FString& TagString : TagStrings)
+			{
+				SequentialTags.Add(HyphenUtil::GetGameplayTagFromString(TagString));
+			}
+		}));
+		Results.Add(Measure(TEXT("Batch"), NumStrings, [&]()
+		{
+			BatchResult = HyphenUtil::GetGameplayTagsFromStrings(TagStrings);
+		}));
+		ensureMsgf(BatchResult.Tags == SequentialTags && BatchResult.FailedIndices.Num() == 0, TEXT("Batch conversion did not match sequential conversion"));
+
+		const TSharedRef<FJsonObject> Parameters = MakeShared<FJsonObject>();
+		Parameters->SetNumberField(TEXT("NumStrings"), NumStrings);
+		Parameters->SetNumberField(TEXT("NumUniqueTags"), AllTags.Num());
+		WriteResults(TEXT("GameplayTagImport"), Parameters, Results);
+	}
+
+	void BenchmarkGameplayTagContainers(const TArray<FString>& Args)
+	{
+		const int32 NumContainers = FMath::Max(GetArg(Args, 0, 1000), 1);
+		const int32 TagsPerContainer = FMath::Max(GetArg(Args, 1, 8), 1);
+		const int32 TagsPerQuery = FMath::Max(GetArg(Args, 2, 2), 1);
+
+		// Every registered tag, the ones past HYPHENUTIL_TAG_BITSET_BITS go to the overflow words
+		FGameplayTagContainer AllTags;
+		UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, false);
+		TArray<FGameplayTag> Tags;
+		AllTags.GetGameplayTagArray(Tags);
+		if (Tags.Num() == 0)
+		{
+			UE_LOG(LogHyphenUtil, Warning, TEXT("HyphenUtil.Bench.GameplayTagContainers needs registered gameplay tags"));
+			return;
+		}
+
+		FRandomStream Random(NumContainers);
+		auto MakeContainer = [&Random, &Tags](int32 NumTags)
+		{
+			FGameplayTagContainer Container;
+			for (int32 i = 0; i < NumTags; i++)
+			{
+				Container.AddTag(Tags[Random.RandHelper(Tags.Num())]);
+			}
+			return Container;
+		};
+		TArray<FGameplayTagContainer> Containers;
+		TArray<FGameplayTagContainer> Queries;
+		TArray<HyphenUtil::FGameplayTagBitContainer> BitContainers;
+		TArray<HyphenUtil::FGameplayTagBitContainer> BitQueries;
+		for (int32 i = 0; i < NumContainers; i++)
+		{
+			BitContainers.Emplace(Containers.Add_GetRef(MakeContainer(TagsPerContainer)));
+			BitQueries.Emplace(Queries.Add_GetRef(MakeContainer(TagsPerQuery)));
+		}
+
+		const int32 NumQueries = NumContainers * NumContainers;
+		int32 StockMatches = 0;
+		int32 BitsetMatches = 0;
+		TArray<FBenchmarkResult> Results;
+		Results.Add(Measure(TEXT("Stock.HasAny"), NumQueries, [&]()
+		{
+			for (const FGameplayTagContainer& Container : Containers)
+			{
+				for (const FGameplayTagContainer& Query : Queries)
+				{
+					StockMatches += Container.HasAny(Query);
+				}
+			}
+		}));
+		Results.Add(Measure(TEXT("Bitset.HasAny"), NumQueries, [&]()
+		{
+			for (const HyphenUtil::FGameplayTagBitContainer& Container : BitContainers)
+			{
+				for (const HyphenUtil::FGameplayTagBitContainer& Query : BitQueries)
+				{
+					BitsetMatches += Container.HasAny(Query);
+				}
+			}
+		}));
+		Results.Add(Measure(TEXT("Stock.HasAll"), NumQueries, [&]()
+		{
+			for (const FGameplayTagContainer& Container : Containers)
+			{
+				for (const FGameplayTagContainer& Query : Queries)
+				{
+					StockMatches += Container.HasAll(Query);
+				}
+			}
+		}));
+		Results.Add(Measure(TEXT("Bitset.HasAll"), NumQueries, [&]()
+		{
+			for (const HyphenUtil::FGameplayTagBitContainer& Container : BitContainers)
+			{
+				for (const HyphenUtil::FGameplayTagBitContainer& Query : BitQueries)
+				{
+					BitsetMatches += Container.HasAll(Query);
+				}
+			}
+		}));
+		ensureMsgf(StockMatches == BitsetMatches, TEXT("Bitset queries matched %d times, stock queries %d times"), BitsetMatches, StockMatches);
+
+		const TSharedRef<FJsonObject> Parameters = MakeShared<FJsonObject>();
+		Parameters->SetNumberField(TEXT("NumContainers"), NumContainers);
+		Parameters->SetNumberField(TEXT("TagsPerContainer"), TagsPerContainer);
+		Parameters->SetNumberField(TEXT("TagsPerQuery"), TagsPerQuery);
+		Parameters->SetNumberField(TEXT("NumTags"), Tags.Num());
+		WriteResults(TEXT("GameplayTagContainers"), Parameters, Results);
+	}
+
+	void BenchmarkNormalDistribution(const TArray<FString>& Args)
+	{
+		const int32 NumSamples = FMath::Max(GetArg(Args, 0, 100000), 1);
+		const int32 Iterations = FMath::Max(GetArg(Args, 1, 100), 1);
+		constexpr float Mean = 3.f;
+		constexpr float StandardDeviation = 2.5f;
+		constexpr float Coefficient = 1.7f;
+
+		// Covers the peak and both tails down to where the fast exp flushes to zero
+		TArray<float> Samples;
+		Samples.SetNumUninitialized(NumSamples);
+		for (int32 i = 0; i < NumSamples; i++)
+		{
+			Samples[i] = Mean + StandardDeviation * FMath::Lerp(-15.f, 15.f, static_cast<float>(i) / NumSamples);
+		}
+		TArray<float> ScalarValues;
+		TArray<float> PreciseValues;
+		TArray<float> FastValues;
+		ScalarValues.SetNumUninitialized(NumSamples);
+		PreciseValues.SetNumUninitialized(NumSamples);
+		FastValues.SetNumUninitialized(NumSamples);
+
+		TArray<FBenchmarkResult> Results;
+		Results.Add(Measure(TEXT("Scalar"), NumSamples * Iterations, [&]()
+		{
+			for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+			{
+				for (int32 i = 0; i < NumSamples; i++)
+				{
+					ScalarValues[i] = UHyphenUtilLibrary::NormalDistribution(Mean, StandardDeviation, Coefficient, Samples[i]);
+				}
+			}
+		}));
+		Results.Add(Measure(TEXT("Precise"), NumSamples * Iterations, [&]()
+		{
+			for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+			{
+				HyphenUtil::NormalDistributionBatch(Mean, StandardDeviation, Coefficient, Samples, PreciseValues, HyphenUtil::ENormalDistributionPrecision::Precise);
+			}
+		}));
+		Results.Add(Measure(TEXT("Fast"), NumSamples * Iterations, [&]()
+		{
+			for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+			{
+				HyphenUtil::NormalDistributionBatch(Mean, StandardDeviation, Coefficient, Samples, FastValues, HyphenUtil::ENormalDistributionPrecision::Fast);
+			}
+		}));
+
+		// Errors against a double reference, relative where the value is a normal float and against the peak everywhere.
+		// Only reported here, the HyphenUtil.Math.NormalDistribution tests hold the bounds.
+		double PreciseMaxRelativeError = 0.0;
+		double FastMaxRelativeError = 0.0;
+		double ScalarMaxPeakError = 0.0;
+		double FastMaxPeakError = 0.0;
+		for (int32 i = 0; i < NumSamples; i++)
+		{
+			const double Distance = static_cast<double>(Samples[i]) - Mean;
+			const double Reference = Coefficient * FMath::Exp(-Distance * Distance / (2.0 * StandardDeviation * StandardDeviation));
+			if (Reference > Coefficient * FLT_MIN)
+			{
+				PreciseMaxRelativeError = FMath::Max(PreciseMaxRelativeError, FMath::Abs(PreciseValues[i] - Reference) / Reference);
+				FastMaxRelativeError = FMath::Max(FastMaxRelativeError, FMath::Abs(FastValues[i] - Reference) / Reference);
+			}
+			ScalarMaxPeakError = FMath::Max(ScalarMaxPeakError, FMath::Abs(ScalarValues[i] - Reference) / Coefficient);
+			FastMaxPeakError = FMath::Max(FastMaxPeakError, FMath::Abs(FastValues[i] - Reference) / Coefficient);
+		}
+		UE_LOG(LogHyphenUtil, Display, TEXT("NormalDistribution max relative error: precise %g, fast %g. Max error against the peak: scalar %g, fast %g"),
+		       PreciseMaxRelativeError, FastMaxRelativeError, ScalarMaxPeakError, FastMaxPeakError);
+
+		const TSharedRef<FJsonObject> Parameters = MakeShared<FJsonObject>();
+		Parameters->SetNumberField(TEXT("NumSamples"), NumSamples);
+		Parameters->SetNumberField(TEXT("Iterations"), Iterations);
+		Parameters->SetNumberField(TEXT("PreciseMaxRelativeError"), PreciseMaxRelativeError);
+		Parameters->SetNumberField(TEXT("FastMaxRelativeError"), FastMaxRelativeError);
+		Parameters->SetNumberField(TEXT("ScalarMaxPeakError"), ScalarMaxPeakError);
+		Parameters->SetNumberField(TEXT("FastMaxPeakError"), FastMaxPeakError);
+		WriteResults(TEXT("NormalDistribution"), Parameters, Results);
+	}
+
+	void BenchmarkGaussianBlur(const TArray<FString>& Args)
+	{
+		const int32 Size = FMath::Max(GetArg(Args, 0, 512), 1);
+		const float Sigma = GetArg(Args, 1, 2.f);
+		const int32 Iterations = FMath::Max(GetArg(Args, 2, 20), 1);
+		const int32 Radius = FMath::CeilToInt(3.f * Sigma);
+
+		// A heatmap with a few hot spots
+		FRandomStream Random(Size);
+		TArray<float> Grid;
+		Grid.SetNumZeroed(Size * Size);
+		for (int32 i = 0; i < Size; i++)
+		{
+			Grid[Random.RandHelper(Grid.Num())] = Random.FRandRange(1.f, 10.f);
+		}
+
+		// Straightforward separable blur with clamped edges, the reference for the vectorized one
+		const HyphenUtil::FGaussianKernelRef KernelRef = HyphenUtil::GetGaussianKernel(Sigma, Radius);
+		const TArray<float>& Kernel = *KernelRef;
+		TArray<float> ScalarGrid;
+		TArray<float> ScalarScratch;
+		ScalarGrid.SetNumUninitialized(Grid.Num());
+		ScalarScratch.SetNumUninitialized(Grid.Num());
+		TArray<FBenchmarkResult> Results;
+		Results.Add(Measure(TEXT("Scalar"), Iterations, [&]()
+		{
+			for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+			{
+				for (int32 Y = 0; Y < Size; Y++)
+				{
+					for (int32 X = 0; X < Size; X++)
+					{
+						float Sum = 0.f;
+						for (int32 KernelIndex = 0; KernelIndex < Kernel.Num(); KernelIndex++)
+						{
+							Sum += Kernel[KernelIndex] * Grid[Y * Size + FMath::Clamp(X + KernelIndex - Radius, 0, Size - 1)];
+						}
+						ScalarScratch[Y * Size + X] = Sum;
+					}
+				}
+				for (int32 Y = 0; Y < Size; Y++)
+				{
+					for (int32 X = 0; X < Size; X++)
+					{
+						float Sum = 0.f;
+						for (int32 KernelIndex = 0; KernelIndex < Kernel.Num(); KernelIndex++)
+						{
+							Sum += Kernel[KernelIndex] * ScalarScratch[FMath::Clamp(Y + KernelIndex - Radius, 0, Size - 1) * Size + X];
+						}
+						ScalarGrid[Y * Size + X] = Sum;
+					}
+				}
+			}
+		}));
+
+		TArray<float> BlurredGrid;
+		TArray<float> Scratch;
+		BlurredGrid.SetNumUninitialized(Grid.Num());
+		// Warm up the scratch grid like a blur that runs every tick
+		HyphenUtil::GaussianBlur(Grid, Size, Size, Sigma, Radius, BlurredGrid, Scratch);
+		Results.Add(Measure(TEXT("GaussianBlur"), Iterations, [&]()
+		{
+			for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+			{
+				HyphenUtil::GaussianBlur(Grid, Size, Size, Sigma, Radius, BlurredGrid, Scratch);
+			}
+		}));
+
+		float MaxError = 0.f;
+		for (int32 i = 0; i < Grid.Num(); i++)
+		{
+			MaxError = FMath::Max(MaxError, FMath::Abs(BlurredGrid[i] - ScalarGrid[i]));
+		}
+		ensureMsgf(MaxError <= 1e-4f, TEXT("GaussianBlur differs from the scalar blur by %g"), MaxError);
+
+		const TSharedRef<FJsonObject> Parameters = MakeShared<FJsonObject>();
+		Parameters->SetNumberField(TEXT("Size"), Size);
+		Parameters->SetNumberField(TEXT("Sigma"), Sigma);
+		Parameters->SetNumberField(TEXT("Radius"), Radius);
+		Parameters->SetNumberField(TEXT("Iterations"), Iterations);
+		Parameters->SetNumberField(TEXT("MaxError"), MaxError);
+		WriteResults(TEXT("GaussianBlur"), Parameters, Results);
+	}
+
+	void BenchmarkGaussianRandom(const TArray<FString>& Args)
+	{
+		const int32 NumValues = FMath::Max(GetArg(Args, 0, 4000000), 1);
+		const int32 Seed = GetArg(Args, 1, 1234);
+
+		// What gameplay code does without a batch sampler, Box-Muller on FRandomStream
+		TArray<float> StreamValues;
+		StreamValues.SetNumUninitialized(NumValues);
+		TArray<FBenchmarkResult> Results;
+		Results.Add(Measure(TEXT("RandomStreamBoxMuller"), NumValues, [&]()
+		{
+			FRandomStream Random(Seed);
+			for (int32 i = 0; i < NumValues; i++)
+			{
+				const float Radius = FMath::Sqrt(-2.f * FMath::Loge(FMath::Max(Random.FRand(), UE_SMALL_NUMBER)));
+				StreamValues[i] = Radius * FMath::Cos(UE_TWO_PI * Random.FRand());
+			}
+		}));
+
+		TArray<float> SingleThreadValues;
+		TArray<float> ParallelValues;
+		SingleThreadValues.SetNumUninitialized(NumValues);
+		ParallelValues.SetNumUninitialized(NumValues);
+		Results.Add(Measure(TEXT("GaussianRandomBatch.SingleThread"), NumValues, [&]()
+		{
+			HyphenUtil::GaussianRandomBatch(Seed, 0.f, 1.f, SingleThreadValues, EParallelForFlags::ForceSingleThread);
+		}));
+		Results.Add(Measure(TEXT("GaussianRandomBatch.Parallel"), NumValues, [&]()
+		{
+			HyphenUtil::GaussianRandomBatch(Seed, 0.f, 1.f, ParallelValues);
+		}));
+
+		double Sum = 0.0;
+		double SquaredSum = 0.0;
+		for (const float Value : ParallelValues)
+		{
+			Sum += Value;
+			SquaredSum += static_cast<double>(Value) * Value;
+		}
+		const double SampleMean = Sum / NumValues;
+		const double SampleVariance = SquaredSum / NumValues - SampleMean * SampleMean;
+		// Only reported here, the HyphenUtil.Math.GaussianRandom test checks them and that threading does not change the values
+		UE_LOG(LogHyphenUtil, Display, TEXT("GaussianRandomBatch sample mean %g, variance %g"), SampleMean, SampleVariance);
+
+		const TSharedRef<FJsonObject> Parameters = MakeShared<FJsonObject>();
+		Parameters->SetNumberField(TEXT("NumValues"), NumValues);
+		Parameters->SetNumberField(TEXT("Seed"), Seed);
+		Parameters->SetNumberField(TEXT("SampleMean"), SampleMean);
+		Parameters->SetNumberField(TEXT("SampleVariance"), SampleVariance);
+		WriteResults(TEXT("GaussianRandom"), Parameters, Results);
+	}
+
+	static FAutoConsoleCommand AssetManagerCommand(
+		TEXT("HyphenUtil.Bench.AssetManager"),
+		TEXT("Stress tests the HyphenAssetManager with unloaded assets from disk and writes timings and allocation counts to Saved/Benchmarks as JSON. ")
+		TEXT("Runs over several frames, works headless with -nullrhi. Args: [NumPaths=10000] [HoldReleaseCyclesPerFrame=5000] [HoldReleaseFrames=10] [FlushCycles=10] [PackagePath=/Engine]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkAssetManager));
+
+	static FAutoConsoleCommand GameplayTagsCommand(
+		TEXT("HyphenUtil.Bench.GameplayTags"),
+		TEXT("Times the HyphenUtil string tag helpers and counts their allocations per call, which should stay at zero once a combination is cached. ")
+		TEXT("Results are written to Saved/Benchmarks as JSON. Args: [Iterations=100000]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkGameplayTags));
+
+	static FAutoConsoleCommand GameplayTagImportCommand(
+		TEXT("HyphenUtil.Bench.GameplayTagImport"),
+		TEXT("Compares converting imported tag strings one at a time against HyphenUtil::GetGameplayTagsFromStrings. ")
+		TEXT("Results are written to Saved/Benchmarks as JSON. Args: [NumStrings=50000]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkGameplayTagImport));
+
+	static FAutoConsoleCommand GameplayTagContainersCommand(
+		TEXT("HyphenUtil.Bench.GameplayTagContainers"),
+		TEXT("Compares HasAny and HasAll of FGameplayTagContainer against HyphenUtil::FGameplayTagBitContainer on random registered tags. ")
+		TEXT("Results are written to Saved/Benchmarks as JSON. Args: [NumContainers=1000] [TagsPerContainer=8] [TagsPerQuery=2]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkGameplayTagContainers));
+
+	static FAutoConsoleCommand NormalDistributionCommand(
+		TEXT("HyphenUtil.Bench.NormalDistribution"),
+		TEXT("Compares UHyphenUtilLibrary::NormalDistribution per sample against HyphenUtil::NormalDistributionBatch in both precisions, ")
+		TEXT("and reports their error against a double reference. Results are written to Saved/Benchmarks as JSON. Args: [NumSamples=100000] [Iterations=100]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkNormalDistribution));
+
+	static FAutoConsoleCommand GaussianBlurCommand(
+		TEXT("HyphenUtil.Bench.GaussianBlur"),
+		TEXT("Compares HyphenUtil::GaussianBlur on a square heatmap against a scalar separable blur and checks they match. ")
+		TEXT("Results are written to Saved/Benchmarks as JSON. Args: [Size=512] [Sigma=2] [Iterations=20]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkGaussianBlur));
+
+	static FAutoConsoleCommand GaussianRandomCommand(
+		TEXT("HyphenUtil.Bench.GaussianRandom"),
+		TEXT("Compares Box-Muller on FRandomStream against HyphenUtil::GaussianRandomBatch single threaded and in ParallelFor, and reports the sample mean and variance. ")
+		TEXT("Results are written to Saved/Benchmarks as JSON. Args: [NumValues=4000000] [Seed=1234]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkGaussianRandom));
+
+	static FAutoConsoleCommand ReferenceGCCommand(
+		TEXT("HyphenUtil.Bench.ReferenceGC"),
+		TEXT("Measures GC time while UHyphenAssetManager holds synthetic objects under reference tags, and the cost of holding and flushing them. ")
+		TEXT("Args: [NumObjects=100000] [NumTags=1000] [Iterations=5]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkReferenceGC));
+}
+
+#endif
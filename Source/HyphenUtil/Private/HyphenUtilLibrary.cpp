@@ -4,6 +4,7 @@
 
 #include "GameplayTagContainer.h"
 #include "HyphenUtil.h"
+#include "HyphenMath.h"
 #include "ISettingsCategory.h"
 #include "ISettingsContainer.h"
 #include "ISettingsModule.h"
@@ -33,7 +34,7 @@ FGameplayTag UHyphenUtilLibrary::CombineGameplayTagWithStrings(const FString& Ta
 
 FGameplayTag UHyphenUtilLibrary::CombineGameplayTagWithTag(const FGameplayTag& Tag, const FGameplayTag& ChildTag)
 {
-	return HyphenUtil::CombineGameplayTagWithString(Tag, ChildTag.GetTagName().ToString());
+	return HyphenUtil::CombineGameplayTagWithName(Tag.GetTagName(), ChildTag.GetTagName());
 }
 
 float UHyphenUtilLibrary::NormalDistribution(float Mean, float StandardDeviation, float Coefficient, float X)
@@ -42,6 +43,19 @@ float UHyphenUtilLibrary::NormalDistribution(float Mean, float StandardDeviation
 	return Coefficient * FMath::Exp(-FMath::Pow(X - Mean, 2.f) / (2.f * FMath::Pow(StandardDeviation, 2.f)));
 }
 
+void UHyphenUtilLibrary::NormalDistributionArray(float Mean, float StandardDeviation, float Coefficient, const TArray<float>& X, bool bFast, TArray<float>& OutValues)
+{
+	OutValues.SetNumUninitialized(X.Num());
+	HyphenUtil::NormalDistributionBatch(Mean, StandardDeviation, Coefficient, X, OutValues,
+	                                    bFast ? HyphenUtil::ENormalDistributionPrecision::Fast : HyphenUtil::ENormalDistributionPrecision::Precise);
+}
+
+void UHyphenUtilLibrary::GaussianRandomArray(int32 Seed, float Mean, float StandardDeviation, int32 Num, TArray<float>& OutValues)
+{
+	OutValues.SetNumUninitialized(FMath::Max(Num, 0));
+	HyphenUtil::GaussianRandomBatch(Seed, Mean, StandardDeviation, OutValues);
+}
+
 int32 UHyphenUtilLibrary::GetObjReferenceCount(UObject* Obj, TArray<UObject*>* OutReferredToObjects)
 {
 	if(!Obj || !Obj->IsValidLowLevelFast()) 
@@ -69,16 +83,14 @@ void UHyphenUtilLibrary::GetWidgetsFromWidgetTree(UUserWidget* Widget, TSubclass
 		return;
 	}
 	OutWidgets.Reset();
-	// Get all widgets from widget tree
-	TArray<UWidget*> AllWidgets;
-	Widget->WidgetTree->GetAllWidgets(AllWidgets);
-	for(auto* ComponentWidget : AllWidgets)
+	// Walk the widget tree without collecting every widget first
+	Widget->WidgetTree->ForEachWidget([&OutWidgets, &WidgetClass](UWidget* ComponentWidget)
 	{
 		if(ComponentWidget->IsA(WidgetClass))
 		{
 			OutWidgets.Emplace(ComponentWidget);
 		}
-	}
+	});
 }
 
 void UHyphenUtilLibrary::SaveSettings(FName Container, FName Category, FName Section)
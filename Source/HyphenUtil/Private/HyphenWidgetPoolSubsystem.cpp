@@ -0,0 +1,261 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenWidgetPoolSubsystem.h"
+
+#include "HyphenAssetManager.h"
+#include "HyphenUtilLibrary.h"
+#include "HyphenUtilLogs.h"
+#include "Blueprint/WidgetTree.h"
+#include "Engine/Engine.h"
+#include "GameFramework/PlayerController.h"
+
+UHyphenWidgetPoolSubsystem* UHyphenWidgetPoolSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	return World ? World->GetSubsystem<UHyphenWidgetPoolSubsystem>() : nullptr;
+}
+
+void UHyphenWidgetPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	ReferenceTagReleasedHandle = UHyphenAssetManager::GetReferenceTagReleased().AddUObject(this, &UHyphenWidgetPoolSubsystem::OnReferenceTagReleased);
+}
+
+void UHyphenWidgetPoolSubsystem::Deinitialize()
+{
+	if (UHyphenAssetManager* AssetManager = Cast<UHyphenAssetManager>(GEngine ? GEngine->AssetManager : nullptr))
+	{
+		AssetManager->GetReferenceTagReleased().Remove(ReferenceTagReleasedHandle);
+	}
+	ReferenceTagReleasedHandle.Reset();
+	PendingPrewarms.Empty();
+	FreeLists.Empty();
+	WidgetTreeCache.Empty();
+	Super::Deinitialize();
+}
+
+void UHyphenWidgetPoolSubsystem::Tick(float DeltaTime)
+{
+	if (PendingPrewarms.Num() == 0)
+	{
+		return;
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + PrewarmBudgetMs / 1000.0;
+	// Creating a widget may start more prewarms, those are added behind the ones this tick covers
+	const int32 NumPrewarms = PendingPrewarms.Num();
+	for (int32 PrewarmIndex = 0; PrewarmIndex < NumPrewarms; PrewarmIndex++)
+	{
+		const TSharedRef<FPendingPrewarm> Prewarm = PendingPrewarms[PrewarmIndex];
+		if (!Prewarm->bLoaded)
+		{
+			continue;
+		}
+		UClass* WidgetClass = Prewarm->WidgetClass.Get();
+		if (WidgetClass == nullptr)
+		{
+			UE_LOG(LogHyphenUtil, Warning, TEXT("Failed to prewarm widgets of class [%s]"), *Prewarm->WidgetClass.ToString());
+			Prewarm->Remaining = 0;
+			continue;
+		}
+
+		while (Prewarm->Remaining > 0 && FPlatformTime::Seconds() < EndTime)
+		{
+			Prewarm->Remaining--;
+			if (FindOrAddFreeList(WidgetClass, Prewarm->ReferenceAssetTag).Widgets.Num() >= MaxPooledWidgetsPerClass)
+			{
+				Prewarm->Remaining = 0;
+				break;
+			}
+			UUserWidget* Widget = CreateWidget(GetWorld(), WidgetClass);
+			// Build the Slate tree now, that is the cost prewarming is meant to pay up front
+			Widget->TakeWidget();
+			// Construction may have added free lists, so the list is looked up again
+			FindOrAddFreeList(WidgetClass, Prewarm->ReferenceAssetTag).Widgets.Add(Widget);
+		}
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+	}
+
+	PendingPrewarms.RemoveAll([](const TSharedRef<FPendingPrewarm>& Prewarm) { return Prewarm->bLoaded && Prewarm->Remaining <= 0; });
+}
+
+TStatId UHyphenWidgetPoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHyphenWidgetPoolSubsystem, STATGROUP_Tickables);
+}
+
+UUserWidget* UHyphenWidgetPoolSubsystem::AcquireWidget(TSubclassOf<UUserWidget> WidgetClass, APlayerController* OwningPlayer)
+{
+	if (!WidgetClass)
+	{
+		return nullptr;
+	}
+
+	UUserWidget* Widget = nullptr;
+	FHyphenWidgetFreeList& FreeList = FindOrAddFreeList(WidgetClass, NAME_None);
+	while (Widget == nullptr && FreeList.Widgets.Num() > 0)
+	{
+		Widget = FreeList.Widgets.Pop(false);
+	}
+
+	if (Widget == nullptr)
+	{
+		return OwningPlayer ? CreateWidget(OwningPlayer, WidgetClass) : CreateWidget(GetWorld(), WidgetClass);
+	}
+
+	if (OwningPlayer)
+	{
+		Widget->SetOwningPlayer(OwningPlayer);
+	}
+	if (Widget->Implements<UHyphenPoolableWidget>())
+	{
+		IHyphenPoolableWidget::Execute_OnPoolAcquired(Widget);
+	}
+	return Widget;
+}
+
+void UHyphenWidgetPoolSubsystem::ReleaseWidget(UUserWidget* Widget)
+{
+	if (Widget == nullptr)
+	{
+		return;
+	}
+
+	Widget->RemoveFromParent();
+	FHyphenWidgetFreeList* FreeList = FreeLists.Find(Widget->GetClass());
+	if (FreeList == nullptr || FreeList->Widgets.Num() >= MaxPooledWidgetsPerClass)
+	{
+		WidgetTreeCache.Remove(Widget);
+		return;
+	}
+	if (!ensureMsgf(!FreeList->Widgets.Contains(Widget), TEXT("Widget [%s] was released to its pool twice"), *Widget->GetName()))
+	{
+		return;
+	}
+	if (Widget->Implements<UHyphenPoolableWidget>())
+	{
+		IHyphenPoolableWidget::Execute_OnPoolReleased(Widget);
+	}
+	FreeList->Widgets.Add(Widget);
+}
+
+void UHyphenWidgetPoolSubsystem::PrewarmWidgets(const TSoftClassPtr<UUserWidget>& WidgetClass, int32 Count, FName ReferenceAssetTag)
+{
+	if (WidgetClass.IsNull() || Count <= 0)
+	{
+		return;
+	}
+
+	const TSharedRef<FPendingPrewarm> Prewarm = MakeShared<FPendingPrewarm>();
+	Prewarm->WidgetClass = WidgetClass;
+	Prewarm->ReferenceAssetTag = ReferenceAssetTag;
+	Prewarm->Remaining = Count;
+	PendingPrewarms.Add(Prewarm);
+
+	const TSharedPtr<FStreamableHandle> Handle = UHyphenAssetManager::RequestAsyncLoad(WidgetClass.ToSoftObjectPath(), ReferenceAssetTag,
+	                                                                               FStreamableDelegate::CreateWeakLambda(this, [Prewarm]() { Prewarm->bLoaded = true; }),
+	                                                                               FStreamableManager::DefaultAsyncLoadPriority, false, false, TEXT("HyphenWidgetPrewarm"));
+	if (!Handle.IsValid())
+	{
+		Prewarm->bLoaded = true;
+	}
+}
+
+void UHyphenWidgetPoolSubsystem::DrainPool(TSubclassOf<UUserWidget> WidgetClass)
+{
+	FHyphenWidgetFreeList FreeList;
+	if (!FreeLists.RemoveAndCopyValue(WidgetClass, FreeList))
+	{
+		return;
+	}
+	for (UUserWidget* Widget : FreeList.Widgets)
+	{
+		WidgetTreeCache.Remove(Widget);
+	}
+	UE_LOG(LogHyphenUtil, Log, TEXT("Drained widget pool of [%s]: %d widgets"), *GetNameSafe(WidgetClass), FreeList.Widgets.Num());
+}
+
+int32 UHyphenWidgetPoolSubsystem::GetNumPooledWidgets(TSubclassOf<UUserWidget> WidgetClass) const
+{
+	const FHyphenWidgetFreeList* FreeList = FreeLists.Find(WidgetClass);
+	return FreeList ? FreeList->Widgets.Num() : 0;
+}
+
+const TArray<UWidget*>& UHyphenWidgetPoolSubsystem::GetCachedWidgetsFromWidgetTree(UUserWidget* Widget, TSubclassOf<UWidget> WidgetClass)
+{
+	static const TArray<UWidget*> NoWidgets;
+	if (Widget == nullptr || WidgetClass == nullptr)
+	{
+		return NoWidgets;
+	}
+
+	if (WidgetTreeCache.Num() >= 256 && !WidgetTreeCache.Contains(Widget))
+	{
+		// Drop widgets that were collected without going back to a pool
+		for (auto It = WidgetTreeCache.CreateIterator(); It; ++It)
+		{
+			if (It.Key().ResolveObjectPtr() == nullptr)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+	TMap<TObjectKey<UClass>, TArray<TWeakObjectPtr<UWidget>>>& WidgetsByClass = WidgetTreeCache.FindOrAdd(Widget);
+	if (const TArray<TWeakObjectPtr<UWidget>>* CachedWidgets = WidgetsByClass.Find(WidgetClass.Get()))
+	{
+		CachedWidgetsResult.Reset(CachedWidgets->Num());
+		for (const TWeakObjectPtr<UWidget>& CachedWidget : *CachedWidgets)
+		{
+			UWidget* ResolvedWidget = CachedWidget.Get();
+			if (ResolvedWidget == nullptr)
+			{
+				break;
+			}
+			CachedWidgetsResult.Add(ResolvedWidget);
+		}
+		if (CachedWidgetsResult.Num() == CachedWidgets->Num())
+		{
+			return CachedWidgetsResult;
+		}
+	}
+
+	// Not scanned yet, or a widget of the tree was collected since, e.g. after being removed from its parent
+	UHyphenUtilLibrary::GetWidgetsFromWidgetTree(Widget, WidgetClass, CachedWidgetsResult);
+	TArray<TWeakObjectPtr<UWidget>>& Widgets = WidgetsByClass.FindOrAdd(WidgetClass.Get());
+	Widgets.Reset(CachedWidgetsResult.Num());
+	for (UWidget* FoundWidget : CachedWidgetsResult)
+	{
+		Widgets.Add(FoundWidget);
+	}
+	return CachedWidgetsResult;
+}
+
+FHyphenWidgetFreeList& UHyphenWidgetPoolSubsystem::FindOrAddFreeList(TSubclassOf<UUserWidget> WidgetClass, FName ReferenceAssetTag)
+{
+	FHyphenWidgetFreeList& FreeList = FreeLists.FindOrAdd(WidgetClass);
+	if (FreeList.ReferenceAssetTag == NAME_None)
+	{
+		FreeList.ReferenceAssetTag = ReferenceAssetTag;
+	}
+	return FreeList;
+}
+
+void UHyphenWidgetPoolSubsystem::OnReferenceTagReleased(FName ReferenceAssetTag)
+{
+	TArray<TSubclassOf<UUserWidget>> DrainedClasses;
+	for (const auto& FreeListPair : FreeLists)
+	{
+		if (FreeListPair.Value.ReferenceAssetTag == ReferenceAssetTag)
+		{
+			DrainedClasses.Add(FreeListPair.Key);
+		}
+	}
+	for (const TSubclassOf<UUserWidget> DrainedClass : DrainedClasses)
+	{
+		DrainPool(DrainedClass);
+	}
+}
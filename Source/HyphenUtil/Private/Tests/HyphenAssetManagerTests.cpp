@@ -0,0 +1,269 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenAssetManager.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Reads and tweaks the asset manager bookkeeping the public API does not expose.
+struct FHyphenAssetManagerTestAccess
+{
+	static int32 GetReferenceCount(FName ReferenceAssetTag)
+	{
+		return UHyphenAssetManager::Get().ReferenceCounter.FindRef(ReferenceAssetTag);
+	}
+
+	static int32 GetNumReferenceObjects(FName ReferenceAssetTag)
+	{
+		const UHyphenAssetManager::FReferenceTagSlots* TagSlots = UHyphenAssetManager::Get().ReferenceLoadedAssets.Find(ReferenceAssetTag);
+		return TagSlots ? TagSlots->Objects.Num() : 0;
+	}
+
+	static bool IsPinned(FName ReferenceAssetTag)
+	{
+		return UHyphenAssetManager::Get().PinnedTags.Contains(ReferenceAssetTag);
+	}
+
+	static bool IsKeptLoaded(const UObject* Asset)
+	{
+		UHyphenAssetManager& AssetManager = UHyphenAssetManager::Get();
+		FScopeLock LoadedAssetsLock(&AssetManager.LoadedAssetsCritical);
+		return AssetManager.ContainsLoadedAsset(Asset);
+	}
+
+	// Drops the tag and its reload history, so earlier runs do not change the outcome.
+	static void ResetTag(FName ReferenceAssetTag)
+	{
+		UHyphenAssetManager::FlushReferenceLoadedAssets(ReferenceAssetTag);
+		UHyphenAssetManager::Get().TagReloadStats.Remove(ReferenceAssetTag);
+	}
+
+	// Pinning config, tests override it with TGuardValue.
+	static int64& PinMemoryCapBytes()
+	{
+		return UHyphenAssetManager::Get().PinMemoryCapBytes;
+	}
+
+	static int32& PinMinReloadCount()
+	{
+		return UHyphenAssetManager::Get().PinMinReloadCount;
+	}
+};
+
+namespace HyphenAssetManagerTests
+{
+	// Engine content that is on disk in every install.
+	TArray<FSoftObjectPath> GetTestAssetPaths()
+	{
+		return {
+			FSoftObjectPath(TEXT("/Engine/BasicShapes/Cube.Cube")),
+			FSoftObjectPath(TEXT("/Engine/BasicShapes/Sphere.Sphere")),
+			FSoftObjectPath(TEXT("/Engine/BasicShapes/Cylinder.Cylinder")),
+		};
+	}
+
+	bool HasAssetManager(FAutomationTestBase& Test)
+	{
+		return Test.TestNotNull(TEXT("HyphenAssetManager is the configured AssetManagerClassName"), Cast<UHyphenAssetManager>(GEngine ? GEngine->AssetManager : nullptr));
+	}
+
+	// Streamable delegates run a few frames after the load by default. Runs them from WaitUntilComplete for the lifetime of the scope.
+	struct FNoStreamableDelegateDelay
+	{
+		FNoStreamableDelegateDelay()
+			: DelayFramesVariable(IConsoleManager::Get().FindConsoleVariable(TEXT("s.StreamableDelegateDelayFrames")))
+		{
+			if (DelayFramesVariable)
+			{
+				PreviousDelayFrames = DelayFramesVariable->GetInt();
+				DelayFramesVariable->Set(0, ECVF_SetByCode);
+			}
+		}
+
+		~FNoStreamableDelegateDelay()
+		{
+			if (DelayFramesVariable)
+			{
+				DelayFramesVariable->Set(PreviousDelayFrames, ECVF_SetByCode);
+			}
+		}
+
+		IConsoleVariable* DelayFramesVariable;
+		int32 PreviousDelayFrames = 0;
+	};
+
+	// Requests the paths under the tag and blocks until the completion has recorded them.
+	bool LoadTag(FAutomationTestBase& Test, const TArray<FSoftObjectPath>& Paths, FName ReferenceAssetTag)
+	{
+		FNoStreamableDelegateDelay NoDelegateDelay;
+		const TSharedPtr<FStreamableHandle> Handle = UHyphenAssetManager::RequestAsyncLoad(Paths, ReferenceAssetTag);
+		if (!Test.TestTrue(TEXT("Request started"), Handle.IsValid()))
+		{
+			return false;
+		}
+		Handle->WaitUntilComplete();
+
+		const FHyphenTagLoadProgress* Progress = UHyphenAssetManager::FindTagLoadProgress(ReferenceAssetTag);
+		return Test.TestTrue(TEXT("Load progress is complete"), Progress && Progress->IsComplete())
+			&& Test.TestEqual(TEXT("Loaded objects are held by the tag"), FHyphenAssetManagerTestAccess::GetNumReferenceObjects(ReferenceAssetTag), Paths.Num());
+	}
+
+	// Loads, holds and releases the tag twice, the second release counts as a reload and pins it.
+	bool LoadAndPinTag(FAutomationTestBase& Test, const TArray<FSoftObjectPath>& Paths, FName ReferenceAssetTag)
+	{
+		for (int32 Cycle = 0; Cycle < 2; Cycle++)
+		{
+			if (!LoadTag(Test, Paths, ReferenceAssetTag))
+			{
+				return false;
+			}
+			UHyphenAssetManager::HoldAssetReference(ReferenceAssetTag);
+			UHyphenAssetManager::ReleaseAssetReference(ReferenceAssetTag);
+		}
+		return Test.TestTrue(FString::Printf(TEXT("%s is pinned after a reload"), *ReferenceAssetTag.ToString()), FHyphenAssetManagerTestAccess::IsPinned(ReferenceAssetTag));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHyphenAssetManagerHoldReleaseTest, "HyphenUtil.AssetManager.HoldRelease", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FHyphenAssetManagerHoldReleaseTest::RunTest(const FString& Parameters)
+{
+	using namespace HyphenAssetManagerTests;
+	if (!HasAssetManager(*this))
+	{
+		return false;
+	}
+
+	const FName Tag = TEXT("HyphenTest.HoldRelease");
+	TGuardValue<int64> NoPinning(FHyphenAssetManagerTestAccess::PinMemoryCapBytes(), 0);
+	FHyphenAssetManagerTestAccess::ResetTag(Tag);
+	const TArray<FSoftObjectPath> Paths = GetTestAssetPaths();
+	if (!LoadTag(*this, Paths, Tag))
+	{
+		FHyphenAssetManagerTestAccess::ResetTag(Tag);
+		return false;
+	}
+
+	int32 NumReleased = 0;
+	const FDelegateHandle ReleasedHandle = UHyphenAssetManager::GetReferenceTagReleased().AddLambda([Tag, &NumReleased](FName ReleasedTag)
+	{
+		NumReleased += ReleasedTag == Tag;
+	});
+
+	UHyphenAssetManager::HoldAssetReference(Tag);
+	UHyphenAssetManager::HoldAssetReference(Tag);
+	TestEqual(TEXT("Two holds are counted"), FHyphenAssetManagerTestAccess::GetReferenceCount(Tag), 2);
+
+	UHyphenAssetManager::ReleaseAssetReference(Tag);
+	TestEqual(TEXT("One hold is left"), FHyphenAssetManagerTestAccess::GetReferenceCount(Tag), 1);
+	TestEqual(TEXT("Objects stay while held"), FHyphenAssetManagerTestAccess::GetNumReferenceObjects(Tag), Paths.Num());
+	TestEqual(TEXT("No release is broadcast while held"), NumReleased, 0);
+
+	UHyphenAssetManager::ReleaseAssetReference(Tag);
+	TestEqual(TEXT("No hold is left"), FHyphenAssetManagerTestAccess::GetReferenceCount(Tag), 0);
+	TestEqual(TEXT("Objects are dropped with the last hold"), FHyphenAssetManagerTestAccess::GetNumReferenceObjects(Tag), 0);
+	TestEqual(TEXT("The last release is broadcast once"), NumReleased, 1);
+
+	UHyphenAssetManager::ReleaseAssetReference(Tag, false);
+	TestEqual(TEXT("Releasing an unheld tag without warning does nothing"), FHyphenAssetManagerTestAccess::GetReferenceCount(Tag), 0);
+
+	UHyphenAssetManager::GetReferenceTagReleased().Remove(ReleasedHandle);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHyphenAssetManagerFlushTest, "HyphenUtil.AssetManager.Flush", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FHyphenAssetManagerFlushTest::RunTest(const FString& Parameters)
+{
+	using namespace HyphenAssetManagerTests;
+	if (!HasAssetManager(*this))
+	{
+		return false;
+	}
+
+	const FName Tag = TEXT("HyphenTest.Flush");
+	TGuardValue<int64> NoPinning(FHyphenAssetManagerTestAccess::PinMemoryCapBytes(), 0);
+	FHyphenAssetManagerTestAccess::ResetTag(Tag);
+	if (!LoadTag(*this, GetTestAssetPaths(), Tag))
+	{
+		FHyphenAssetManagerTestAccess::ResetTag(Tag);
+		return false;
+	}
+
+	int32 NumReleased = 0;
+	const FDelegateHandle ReleasedHandle = UHyphenAssetManager::GetReferenceTagReleased().AddLambda([Tag, &NumReleased](FName ReleasedTag)
+	{
+		NumReleased += ReleasedTag == Tag;
+	});
+
+	UHyphenAssetManager::HoldAssetReference(Tag);
+	UHyphenAssetManager::HoldAssetReference(Tag);
+	UHyphenAssetManager::FlushReferenceLoadedAssets(Tag);
+	TestEqual(TEXT("Flush drops every hold"), FHyphenAssetManagerTestAccess::GetReferenceCount(Tag), 0);
+	TestEqual(TEXT("Flush drops the objects"), FHyphenAssetManagerTestAccess::GetNumReferenceObjects(Tag), 0);
+	TestEqual(TEXT("Flush broadcasts the release once"), NumReleased, 1);
+
+	UHyphenAssetManager::ReleaseAssetReference(Tag, false);
+	TestEqual(TEXT("A release after the flush does nothing"), FHyphenAssetManagerTestAccess::GetReferenceCount(Tag), 0);
+	TestEqual(TEXT("A release after the flush broadcasts nothing"), NumReleased, 1);
+
+	UHyphenAssetManager::GetReferenceTagReleased().Remove(ReleasedHandle);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHyphenAssetManagerPinTest, "HyphenUtil.AssetManager.Pin", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FHyphenAssetManagerPinTest::RunTest(const FString& Parameters)
+{
+	using namespace HyphenAssetManagerTests;
+	if (!HasAssetManager(*this))
+	{
+		return false;
+	}
+
+	const FName Tag = TEXT("HyphenTest.Pin");
+	const FName SharedTag = TEXT("HyphenTest.PinShared");
+	// Any size fits and the first reload pins
+	TGuardValue<int64> PinCap(FHyphenAssetManagerTestAccess::PinMemoryCapBytes(), MAX_int64);
+	TGuardValue<int32> PinAfterFirstReload(FHyphenAssetManagerTestAccess::PinMinReloadCount(), 1);
+	FHyphenAssetManagerTestAccess::ResetTag(Tag);
+	FHyphenAssetManagerTestAccess::ResetTag(SharedTag);
+
+	const TArray<FSoftObjectPath> Paths = GetTestAssetPaths();
+	// The shared tag pins the first asset of the other tag as well
+	if (!LoadAndPinTag(*this, Paths, Tag) || !LoadAndPinTag(*this, {Paths[0]}, SharedTag))
+	{
+		FHyphenAssetManagerTestAccess::ResetTag(Tag);
+		FHyphenAssetManagerTestAccess::ResetTag(SharedTag);
+		return false;
+	}
+
+	TArray<const UObject*> Assets;
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		Assets.Add(Path.ResolveObject());
+		TestTrue(FString::Printf(TEXT("%s is kept by the pin"), *Path.ToString()), FHyphenAssetManagerTestAccess::IsKeptLoaded(Assets.Last()));
+	}
+
+	UHyphenAssetManager& AssetManager = UHyphenAssetManager::Get();
+	AssetManager.ReleaseLoadedAsset(Assets[1]);
+	TestTrue(TEXT("ReleaseLoadedAsset keeps an asset a pin needs"), FHyphenAssetManagerTestAccess::IsKeptLoaded(Assets[1]));
+	AssetManager.AddLoadedAsset(Assets[2]);
+
+	UHyphenAssetManager::FlushReferenceLoadedAssets(Tag);
+	TestFalse(TEXT("Flush unpins the tag"), FHyphenAssetManagerTestAccess::IsPinned(Tag));
+	TestTrue(TEXT("An asset the other pinned tag shares stays"), FHyphenAssetManagerTestAccess::IsKeptLoaded(Assets[0]));
+	TestFalse(TEXT("An asset released while pinned goes with the pin"), FHyphenAssetManagerTestAccess::IsKeptLoaded(Assets[1]));
+	TestTrue(TEXT("An asset added with AddLoadedAsset while pinned stays"), FHyphenAssetManagerTestAccess::IsKeptLoaded(Assets[2]));
+
+	AssetManager.ReleaseLoadedAsset(Assets[2]);
+	TestFalse(TEXT("ReleaseLoadedAsset drops an unpinned asset"), FHyphenAssetManagerTestAccess::IsKeptLoaded(Assets[2]));
+	UHyphenAssetManager::FlushReferenceLoadedAssets(SharedTag);
+	TestFalse(TEXT("The last unpin drops the shared asset"), FHyphenAssetManagerTestAccess::IsKeptLoaded(Assets[0]));
+	return true;
+}
+
+#endif
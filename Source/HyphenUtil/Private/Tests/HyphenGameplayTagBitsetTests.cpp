@@ -0,0 +1,110 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenGameplayTagBitset.h"
+#include "HyphenGameplayTagCache.h"
+#include "GameplayTagsManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHyphenGameplayTagBitsetOverflowTest, "HyphenUtil.GameplayTags.Bitset.Overflow", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FHyphenGameplayTagBitsetOverflowTest::RunTest(const FString& Parameters)
+{
+	using HyphenUtil::FGameplayTagBitset;
+	constexpr int32 OverflowBit = FGameplayTagBitset::NumInlineBits + 5;
+	constexpr int32 FarOverflowBit = FGameplayTagBitset::NumInlineBits * 4 + 70;
+
+	FGameplayTagBitset Bitset;
+	Bitset.Set(3);
+	Bitset.Set(OverflowBit);
+	Bitset.Set(FarOverflowBit);
+	TestTrue(TEXT("Inline bit is set"), Bitset.Test(3));
+	TestTrue(TEXT("Bit past the inline width is set"), Bitset.Test(OverflowBit) && Bitset.Test(FarOverflowBit));
+	TestFalse(TEXT("Neighbouring bit past the inline width is not set"), Bitset.Test(OverflowBit + 1));
+	TestFalse(TEXT("Bit past every overflow word is not set"), Bitset.Test(FarOverflowBit * 2));
+	TestFalse(TEXT("Negative index is not set"), Bitset.Test(INDEX_NONE));
+
+	TArray<int32> SetBits;
+	Bitset.ForEachSetBit([&SetBits](int32 Index) { SetBits.Add(Index); });
+	TestTrue(TEXT("ForEachSetBit visits inline and overflow bits in order"), SetBits == TArray<int32>{3, OverflowBit, FarOverflowBit});
+
+	FGameplayTagBitset OverflowOnly;
+	OverflowOnly.Set(OverflowBit);
+	TestTrue(TEXT("Bitsets intersect in the overflow words"), Bitset.Intersects(OverflowOnly));
+	TestTrue(TEXT("Bitset contains a subset in the overflow words"), Bitset.Contains(OverflowOnly));
+	TestFalse(TEXT("Subset does not contain a bit past its own overflow words"), OverflowOnly.Contains(Bitset));
+	TestFalse(TEXT("Bitset with only overflow bits is not empty"), OverflowOnly.IsEmpty());
+
+	FGameplayTagBitset Appended;
+	Appended.Set(3);
+	Appended.Append(OverflowOnly);
+	Appended.Set(FarOverflowBit);
+	TestTrue(TEXT("Same bits compare equal, however they were set"), Appended == Bitset);
+	OverflowOnly.Set(FarOverflowBit * 2);
+	TestFalse(TEXT("Bits past the overflow words of the other bitset make them differ"), OverflowOnly == Bitset);
+
+	Bitset.Reset();
+	TestTrue(TEXT("Reset clears the overflow words"), Bitset.IsEmpty() && !Bitset.Test(OverflowBit));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHyphenGameplayTagBitContainerParityTest, "HyphenUtil.GameplayTags.BitContainer.Parity", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FHyphenGameplayTagBitContainerParityTest::RunTest(const FString& Parameters)
+{
+	FGameplayTagContainer AllTags;
+	UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, false);
+	TArray<FGameplayTag> Tags;
+	AllTags.GetGameplayTagArray(Tags);
+	if (Tags.Num() < 2)
+	{
+		AddWarning(TEXT("Parity needs at least two registered gameplay tags"));
+		return true;
+	}
+	HyphenUtil::FGameplayTagIndex::Get().Update();
+
+	FRandomStream Random(Tags.Num());
+	auto MakeContainer = [&Random, &Tags](int32 MaxTags)
+	{
+		FGameplayTagContainer Container;
+		for (int32 i = Random.RandRange(0, MaxTags); i > 0; i--)
+		{
+			Container.AddTag(Tags[Random.RandHelper(Tags.Num())]);
+		}
+		return Container;
+	};
+
+	for (int32 Iteration = 0; Iteration < 500; Iteration++)
+	{
+		const FGameplayTagContainer Container = MakeContainer(8);
+		const FGameplayTagContainer Query = MakeContainer(3);
+		const HyphenUtil::FGameplayTagBitContainer BitContainer(Container);
+		const HyphenUtil::FGameplayTagBitContainer BitQuery(Query);
+		const FString Context = FString::Printf(TEXT("[%s] and [%s]"), *Container.ToStringSimple(), *Query.ToStringSimple());
+
+		if (!TestTrue(TEXT("Bit containers only hold indexed tags"), BitContainer.GetUnindexedTags().IsEmpty() && BitQuery.GetUnindexedTags().IsEmpty())
+			|| !TestEqual(FString::Printf(TEXT("HasAny of %s"), *Context), BitContainer.HasAny(BitQuery), Container.HasAny(Query))
+			|| !TestEqual(FString::Printf(TEXT("HasAnyExact of %s"), *Context), BitContainer.HasAnyExact(BitQuery), Container.HasAnyExact(Query))
+			|| !TestEqual(FString::Printf(TEXT("HasAll of %s"), *Context), BitContainer.HasAll(BitQuery), Container.HasAll(Query))
+			|| !TestEqual(FString::Printf(TEXT("HasAllExact of %s"), *Context), BitContainer.HasAllExact(BitQuery), Container.HasAllExact(Query))
+			|| !TestTrue(FString::Printf(TEXT("ToContainer of [%s] gives the same tags"), *Container.ToStringSimple()), BitContainer.ToContainer() == Container))
+		{
+			return false;
+		}
+
+		const FGameplayTag Tag = Tags[Random.RandHelper(Tags.Num())];
+		const int32 DenseIndex = HyphenUtil::FGameplayTagIndex::Get().FindDenseIndex(Tag);
+		if (!TestEqual(FString::Printf(TEXT("HasTag %s in [%s]"), *Tag.ToString(), *Container.ToStringSimple()), BitContainer.HasTag(Tag), Container.HasTag(Tag))
+			|| !TestEqual(FString::Printf(TEXT("HasTagExact %s in [%s]"), *Tag.ToString(), *Container.ToStringSimple()), BitContainer.HasTagExact(Tag), Container.HasTagExact(Tag))
+			|| !TestEqual(TEXT("HasTag by dense index matches HasTag"), BitContainer.HasTag(DenseIndex), Container.HasTag(Tag))
+			|| !TestEqual(TEXT("HasTagExact by dense index matches HasTagExact"), BitContainer.HasTagExact(DenseIndex), Container.HasTagExact(Tag)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+#endif
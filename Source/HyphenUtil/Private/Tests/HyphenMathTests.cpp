@@ -0,0 +1,181 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+
+#include "HyphenMath.h"
+#include "HyphenUtilLibrary.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HyphenMathTests
+{
+	constexpr float Mean = 3.f;
+	constexpr float StandardDeviation = 2.5f;
+	constexpr float Coefficient = 1.7f;
+
+	// Samples from Mean - Deviations * StandardDeviation to Mean + Deviations * StandardDeviation. An odd count covers the remainder path.
+	TArray<float> MakeSamples(float Deviations, int32 NumSamples = 1001)
+	{
+		TArray<float> Samples;
+		Samples.SetNumUninitialized(NumSamples);
+		for (int32 i = 0; i < NumSamples; i++)
+		{
+			Samples[i] = Mean + StandardDeviation * FMath::Lerp(-Deviations, Deviations, static_cast<float>(i) / (NumSamples - 1));
+		}
+		return Samples;
+	}
+
+	float GetExponent(float X)
+	{
+		return (X - Mean) * (X - Mean) / (2.f * StandardDeviation * StandardDeviation);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHyphenMathNormalDistributionPreciseTest, "HyphenUtil.Math.NormalDistribution.Precise", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FHyphenMathNormalDistributionPreciseTest::RunTest(const FString& Parameters)
+{
+	using namespace HyphenMathTests;
+	const TArray<float> Samples = MakeSamples(5.f);
+	TArray<float> Values;
+	Values.SetNumUninitialized(Samples.Num());
+	HyphenUtil::NormalDistributionBatch(Mean, StandardDeviation, Coefficient, Samples, Values, HyphenUtil::ENormalDistributionPrecision::Precise);
+
+	for (int32 i = 0; i < Samples.Num(); i++)
+	{
+		const float Expected = UHyphenUtilLibrary::NormalDistribution(Mean, StandardDeviation, Coefficient, Samples[i]);
+		// The exponent is rounded differently than in the scalar formula, one ulp of it is a relative error of the same size
+		const float Tolerance = 8.f * FLT_EPSILON * FMath::Max(1.f, GetExponent(Samples[i]));
+		if (!TestTrue(FString::Printf(TEXT("Precise value at %g is %g, scalar %g"), Samples[i], Values[i], Expected),
+		              FMath::Abs(Values[i] - Expected) <= Tolerance * Expected))
+		{
+			return false;
+		}
+	}
+
+	TArray<float> InPlaceValues = Samples;
+	HyphenUtil::NormalDistributionBatch(Mean, StandardDeviation, Coefficient, InPlaceValues, InPlaceValues, HyphenUtil::ENormalDistributionPrecision::Precise);
+	TestTrue(TEXT("Evaluating in place gives the same values"), InPlaceValues == Values);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHyphenMathNormalDistributionFastTest, "HyphenUtil.Math.NormalDistribution.Fast", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FHyphenMathNormalDistributionFastTest::RunTest(const FString& Parameters)
+{
+	using namespace HyphenMathTests;
+	// Down to where the fast exp flushes to zero
+	const TArray<float> Samples = MakeSamples(15.f, 100001);
+	TArray<float> Values;
+	Values.SetNumUninitialized(Samples.Num());
+	HyphenUtil::NormalDistributionBatch(Mean, StandardDeviation, Coefficient, Samples, Values, HyphenUtil::ENormalDistributionPrecision::Fast);
+
+	double MaxRelativeError = 0.0;
+	for (int32 i = 0; i < Samples.Num(); i++)
+	{
+		const double Distance = static_cast<double>(Samples[i]) - Mean;
+		const double Reference = Coefficient * FMath::Exp(-Distance * Distance / (2.0 * StandardDeviation * StandardDeviation));
+		if (Reference > Coefficient * FLT_MIN)
+		{
+			MaxRelativeError = FMath::Max(MaxRelativeError, FMath::Abs(Values[i] - Reference) / Reference);
+		}
+		else if (!TestTrue(FString::Printf(TEXT("Fast value at %g is %g, below normal floats"), Samples[i], Values[i]), Values[i] <= Coefficient * FLT_MIN))
+		{
+			return false;
+		}
+	}
+	AddInfo(FString::Printf(TEXT("Fast max relative error %g"), MaxRelativeError));
+	TestTrue(FString::Printf(TEXT("Fast max relative error %g is within NormalDistributionFastMaxRelativeError"), MaxRelativeError),
+	         MaxRelativeError <= HyphenUtil::NormalDistributionFastMaxRelativeError);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHyphenMathGaussianKernelTest, "HyphenUtil.Math.GaussianKernel", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FHyphenMathGaussianKernelTest::RunTest(const FString& Parameters)
+{
+	const HyphenUtil::FGaussianKernelRef Kernel = HyphenUtil::GetGaussianKernel(2.f, 6);
+	if (!TestEqual(TEXT("Kernel has 2 * Radius + 1 weights"), Kernel->Num(), 13))
+	{
+		return false;
+	}
+	float Sum = 0.f;
+	for (const float Weight : *Kernel)
+	{
+		Sum += Weight;
+	}
+	TestEqual(TEXT("Weights sum to 1"), Sum, 1.f, KINDA_SMALL_NUMBER);
+	TestTrue(TEXT("Kernel is symmetric and peaks at the center"), (*Kernel)[0] == (*Kernel)[12] && (*Kernel)[6] > (*Kernel)[5]);
+
+	TestTrue(TEXT("Sigmas within a step share the cached kernel"),
+	         &*HyphenUtil::GetGaussianKernel(2.f + HyphenUtil::GaussianKernelSigmaStep * 0.25f, 6) == &*Kernel);
+	const HyphenUtil::FGaussianKernelRef IdentityKernel = HyphenUtil::GetGaussianKernel(0.f, 2);
+	TestTrue(TEXT("Sigma of 0 gives the identity kernel"), (*IdentityKernel)[2] == 1.f && (*IdentityKernel)[0] == 0.f && (*IdentityKernel)[4] == 0.f);
+
+	const HyphenUtil::FGaussianKernel2D Kernel2D = HyphenUtil::GetGaussianKernel2D(2.f, 0.f, 6, 2);
+	TestEqual(TEXT("2D kernel keeps the row radius"), Kernel2D.GetRadiusX(), 6);
+	TestEqual(TEXT("2D kernel keeps the column radius"), Kernel2D.GetRadiusY(), 2);
+	TestEqual(TEXT("2D weight is the product of the row and column weights"), Kernel2D.GetWeight(1, 0), (*Kernel)[7]);
+	TestEqual(TEXT("2D weight outside of the kernel is 0"), Kernel2D.GetWeight(0, 3), 0.f);
+
+	// A 2D kernel without spread along columns only blurs the rows
+	TArray<float> Grid;
+	Grid.SetNumZeroed(16 * 16);
+	Grid[8 * 16 + 8] = 1.f;
+	TArray<float> BlurredGrid;
+	TArray<float> Scratch;
+	BlurredGrid.SetNumUninitialized(Grid.Num());
+	HyphenUtil::GaussianBlur(Grid, 16, 16, Kernel2D, BlurredGrid, Scratch);
+	TestEqual(TEXT("Blurred row matches the row kernel"), BlurredGrid[8 * 16 + 9], (*Kernel)[7], KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Neighbouring rows stay empty"), BlurredGrid[7 * 16 + 8], 0.f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHyphenMathGaussianRandomTest, "HyphenUtil.Math.GaussianRandom", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FHyphenMathGaussianRandomTest::RunTest(const FString& Parameters)
+{
+	using namespace HyphenMathTests;
+	constexpr int32 Seed = 1234;
+	// Several chunks and a partial one
+	constexpr int32 NumValues = 3 * HyphenUtil::GaussianRandomChunkSize + 123;
+
+	TArray<float> SingleThreadValues;
+	TArray<float> ParallelValues;
+	SingleThreadValues.SetNumUninitialized(NumValues);
+	ParallelValues.SetNumUninitialized(NumValues);
+	HyphenUtil::GaussianRandomBatch(Seed, Mean, StandardDeviation, SingleThreadValues, EParallelForFlags::ForceSingleThread);
+	HyphenUtil::GaussianRandomBatch(Seed, Mean, StandardDeviation, ParallelValues);
+	TestTrue(TEXT("Single threaded and parallel values are identical"), SingleThreadValues == ParallelValues);
+
+	// A shorter run ends inside a chunk, the values depend only on the seed and their index
+	TArray<float> PrefixValues;
+	PrefixValues.SetNumUninitialized(HyphenUtil::GaussianRandomChunkSize + 7);
+	HyphenUtil::GaussianRandomBatch(Seed, Mean, StandardDeviation, PrefixValues);
+	TestTrue(TEXT("A shorter run with the same seed is a prefix of the longer run"),
+	         FMemory::Memcmp(PrefixValues.GetData(), ParallelValues.GetData(), PrefixValues.Num() * sizeof(float)) == 0);
+
+	TArray<float> OtherSeedValues;
+	OtherSeedValues.SetNumUninitialized(NumValues);
+	HyphenUtil::GaussianRandomBatch(Seed + 1, Mean, StandardDeviation, OtherSeedValues);
+	TestTrue(TEXT("Another seed gives other values"), OtherSeedValues != ParallelValues);
+
+	double Sum = 0.0;
+	double SquaredSum = 0.0;
+	for (const float Value : ParallelValues)
+	{
+		Sum += Value;
+		SquaredSum += static_cast<double>(Value) * Value;
+	}
+	const double SampleMean = Sum / NumValues;
+	const double SampleVariance = SquaredSum / NumValues - SampleMean * SampleMean;
+	// Five standard errors of the sample mean and variance of a normal distribution
+	const double Variance = static_cast<double>(StandardDeviation) * StandardDeviation;
+	const double MeanTolerance = 5.0 * StandardDeviation / FMath::Sqrt(static_cast<double>(NumValues));
+	const double VarianceTolerance = 5.0 * Variance * FMath::Sqrt(2.0 / NumValues);
+	TestTrue(FString::Printf(TEXT("Sample mean %g is within %g of %g"), SampleMean, MeanTolerance, Mean), FMath::Abs(SampleMean - Mean) <= MeanTolerance);
+	TestTrue(FString::Printf(TEXT("Sample variance %g is within %g of %g"), SampleVariance, VarianceTolerance, Variance), FMath::Abs(SampleVariance - Variance) <= VarianceTolerance);
+	return true;
+}
+
+#endif
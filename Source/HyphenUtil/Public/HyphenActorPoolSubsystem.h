@@ -0,0 +1,127 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HyphenAssetManager.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/Interface.h"
+#include "HyphenActorPoolSubsystem.generated.h"
+
+class FHyphenSpawnBatch;
+class UActorComponent;
+class UPrimitiveComponent;
+
+UINTERFACE(BlueprintType)
+class HYPHENUTIL_API UHyphenPoolableActor : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Pooled actors run BeginPlay once when they are first spawned.
+ * Per use setup and teardown belong in these hooks, which run every time the actor leaves or returns to its pool.
+ */
+class HYPHENUTIL_API IHyphenPoolableActor
+{
+	GENERATED_BODY()
+
+public:
+	// Called after the actor is taken from the pool and moved to its new transform.
+	UFUNCTION(BlueprintNativeEvent, Category = "HyphenUtil|ActorPool")
+	void OnPoolActivated();
+	// Called before the actor is hidden and returned to the pool. Actors spawned by PrewarmActors are pooled without it, they were never activated.
+	UFUNCTION(BlueprintNativeEvent, Category = "HyphenUtil|ActorPool")
+	void OnPoolDeactivated();
+};
+
+// A pooled actor and the components deactivation stopped, restarted on activation.
+USTRUCT()
+struct FHyphenPooledActor
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TObjectPtr<AActor> Actor;
+	TArray<TWeakObjectPtr<UActorComponent>> TickingComponents;
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> SimulatingComponents;
+};
+
+USTRUCT()
+struct FHyphenActorFreeList
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TArray<FHyphenPooledActor> Actors;
+	// Reference tag the class was loaded with, the free list is drained when the tag is released.
+	FName ReferenceAssetTag;
+};
+
+/**
+ * Reuses actors per class instead of spawning and destroying them.
+ * Released actors are hidden, lose collision and stop ticking, and their components stop ticking and simulating physics,
+ * until they are acquired again.
+ */
+UCLASS(config=Game)
+class HYPHENUTIL_API UHyphenActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UHyphenActorPoolSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Takes a pooled actor of ActorClass, or spawns one if the pool is empty.
+	UFUNCTION(BlueprintCallable, Category = "HyphenUtil|ActorPool", meta = (DeterminesOutputType = "ActorClass"))
+	AActor* AcquireActor(TSubclassOf<AActor> ActorClass, const FTransform& Transform);
+	// Loads the class through UHyphenAssetManager::GetSubclass under ReferenceAssetTag, then acquires an actor of it.
+	template <typename ActorType>
+	ActorType* AcquireSoftClassActor(const TSoftClassPtr<ActorType>& ActorClass, const FTransform& Transform, FName ReferenceAssetTag = NAME_None);
+
+	// Returns an actor to the pool of its class. Actors without a pool, e.g. after their tag was released, are destroyed.
+	UFUNCTION(BlueprintCallable, Category = "HyphenUtil|ActorPool")
+	void ReleaseActor(AActor* Actor);
+
+	/**
+	 * Loads ActorClass under ReferenceAssetTag and spawns Count pooled actors through UHyphenSpawnSubsystem.
+	 * The pool of the class is drained once the tag is released.
+	 */
+	TSharedPtr<FHyphenSpawnBatch> PrewarmActors(const TSoftClassPtr<AActor>& ActorClass, int32 Count, FName ReferenceAssetTag);
+
+	// Destroys every pooled actor of ActorClass. Acquired actors are destroyed when they are released.
+	void DrainPool(TSubclassOf<AActor> ActorClass);
+	int32 GetNumPooledActors(TSubclassOf<AActor> ActorClass) const;
+
+private:
+	FHyphenActorFreeList& FindOrAddFreeList(TSubclassOf<AActor> ActorClass, FName ReferenceAssetTag);
+	// Adds Actor to the free list of its class, or destroys it if there is none. OnPoolDeactivated only runs if bWasActivated.
+	void PoolActor(AActor* Actor, bool bWasActivated);
+	void ActivateActor(const FHyphenPooledActor& PooledActor, const FTransform& Transform);
+	void DeactivateActor(FHyphenPooledActor& PooledActor, bool bWasActivated);
+	void OnReferenceTagReleased(FName ReferenceAssetTag);
+
+	// Pooled actors kept per class, extra released actors are destroyed.
+	UPROPERTY(Config)
+	int32 MaxPooledActorsPerClass = 256;
+
+	UPROPERTY()
+	TMap<TSubclassOf<AActor>, FHyphenActorFreeList> FreeLists;
+	FDelegateHandle ReferenceTagReleasedHandle;
+};
+
+template <typename ActorType>
+ActorType* UHyphenActorPoolSubsystem::AcquireSoftClassActor(const TSoftClassPtr<ActorType>& ActorClass, const FTransform& Transform, FName ReferenceAssetTag)
+{
+	const TSubclassOf<ActorType> LoadedClass = UHyphenAssetManager::GetSubclass(ActorClass, ReferenceAssetTag);
+	if (!LoadedClass)
+	{
+		return nullptr;
+	}
+	FindOrAddFreeList(LoadedClass, ReferenceAssetTag);
+	return Cast<ActorType>(AcquireActor(LoadedClass, Transform));
+}
@@ -0,0 +1,24 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtr.h"
+
+namespace HyphenUtil
+{
+	/**
+	 * Reports released objects that are still alive, typically right after flushing reference tags and running a full GC.
+	 *
+	 * The reverse reference graph of all live objects is built with FReferenceFinder on the game thread, then the shortest
+	 * referencer chains from the survivors to a GC root are searched in parallel. Each chain is logged and appended to
+	 * Saved/Logs/HyphenAssetLeaks-<timestamp>.txt as soon as it is found, so a partial report survives a crash.
+	 * Must be called on the game thread, outside of garbage collection.
+	 *
+	 * @param ReleasedObjects Objects that are expected to be gone.
+	 * @param IgnoredObjects Survivors that are intentionally kept alive and should not be reported.
+	 * @return The number of leaked objects.
+	 */
+	HYPHENUTIL_API int32 DetectAssetLeaks(const TArray<FWeakObjectPtr>& ReleasedObjects, const TSet<FObjectKey>& IgnoredObjects = TSet<FObjectKey>());
+}
@@ -3,9 +3,21 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Ticker.h"
 #include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "IO/IoDispatcher.h"
+#include <atomic>
 #include "HyphenAssetManager.generated.h"
 
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+// Attributes allocations in this scope to HyphenUtil/AssetManager/<ReferenceAssetTag>.
+#define HYPHEN_LLM_SCOPE_REFERENCE_TAG(ReferenceAssetTag) \
+	FLLMScope PREPROCESSOR_JOIN(HyphenReferenceTagLLMScope, __LINE__)(UHyphenAssetManager::GetReferenceTagLLMName(ReferenceAssetTag), false, ELLMTagSet::None, ELLMTracker::Default)
+#else
+#define HYPHEN_LLM_SCOPE_REFERENCE_TAG(ReferenceAssetTag)
+#endif
+
 /**
  * 
  */
@@ -22,21 +34,64 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int Priority = 0;
 	FStreamableDelegate OnLoadComplete;
+	// FPlatformTime::Seconds() when the load was requested, used to measure load cost.
+	double RequestTime = 0.0;
 };
 
-USTRUCT()
-struct FHyphenReferenceAssetObjects
+// Broadcast once per frame with every tagged request that completed since the last broadcast.
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHyphenReferenceAssetLoadComplete, const TArray<FHyphenReferenceAssetLoadInfo>&,
+                                            LoadInfos);
+
+// Broadcast when a reference tag stops holding its objects, after the last release or a flush.
+DECLARE_MULTICAST_DELEGATE_OneParam(FHyphenReferenceTagReleased, FName);
+
+/**
+ * Progress of the startup warm-up preload.
+ * Counters are atomic so loading screens can poll them from any thread without locking.
+ */
+struct HYPHENUTIL_API FHyphenWarmUpProgress
 {
-	GENERATED_BODY()
-public:
-	UPROPERTY()
-	TSet<const UObject*> Objects;
+	std::atomic<int32> RequestedAssets{0};
+	std::atomic<int32> LoadedAssets{0};
+	std::atomic<int32> PendingRequests{0};
+	std::atomic<bool> bStarted{false};
+
+	// Returns loaded / requested in [0, 1], or 1 if nothing was requested.
+	float GetProgress() const;
+	bool IsComplete() const;
 };
 
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHyphenReferenceAssetLoadComplete, const FHyphenReferenceAssetLoadInfo&,
-                                            LoadInfo);
+UENUM(BlueprintType)
+enum class EHyphenReferenceScope : uint8
+{
+	// Held until explicitly released, survives world changes.
+	Session,
+	// Released automatically when the owning world is cleaned up.
+	World,
+};
 
-UCLASS()
+/**
+ * Load progress of a single reference tag, updated from completion callbacks.
+ * Records are never freed once created, so a pointer returned by FindTagLoadProgress can be read from any thread
+ * (including the Slate render thread) without locks or allocation.
+ */
+struct HYPHENUTIL_API FHyphenTagLoadProgress
+{
+	explicit FHyphenTagLoadProgress(FName InAssetTag) : AssetTag(InAssetTag) {}
+
+	const FName AssetTag;
+	std::atomic<int32> RequestedAssets{0};
+	std::atomic<int32> LoadedAssets{0};
+	std::atomic<int32> FailedAssets{0};
+	std::atomic<int64> LoadedBytes{0};
+
+	// Returns (loaded + failed) / requested in [0, 1], or 1 if nothing was requested.
+	float GetProgress() const;
+	bool IsComplete() const;
+	void Reset();
+};
+
+UCLASS(config=Game)
 class HYPHENUTIL_API UHyphenAssetManager : public UAssetManager
 {
 	GENERATED_BODY()
@@ -44,6 +99,8 @@ class HYPHENUTIL_API UHyphenAssetManager : public UAssetManager
 public:
 	UHyphenAssetManager();
 
+	virtual void StartInitialLoading() override;
+
 	/** Returns the current AssetManager object */
 	static UHyphenAssetManager& Get();
 
@@ -74,8 +131,30 @@ public:
 	static void HoldAssetReference(FName ReferenceAssetTag);
 	static void ReleaseAssetReference(FName ReferenceAssetTag, bool bWarnIfNoReference = true);
 	static void FlushAllReferenceLoadedAssets();
+	// Flushes all reference tags, runs a full GC and reports every previously held object that is still alive.
+	static void FlushAndDetectAssetLeaks();
 	static void FlushReferenceLoadedAssets(FName ReferenceAssetTag);
 
+	// Holds a reference tag for the lifetime of the world of WorldContextObject. The hold is released on world cleanup.
+	static void HoldWorldAssetReference(FName ReferenceAssetTag, const UObject* WorldContextObject);
+	static void ReleaseWorldAssetReference(FName ReferenceAssetTag, const UObject* WorldContextObject);
+	// Moves one hold of a tag between the session scope and the scope of the world of WorldContextObject without unloading.
+	static void MoveAssetReferenceScope(FName ReferenceAssetTag, const UObject* WorldContextObject, EHyphenReferenceScope NewScope);
+	/**
+	 * World-scoped holds of these tags survive the next world cleanup and are handed to the next game world
+	 * that is initialized, so assets the next map requests again are not unloaded in between.
+	 */
+	static void CarryOverAssetReferences(const TArray<FName>& ReferenceAssetTags);
+
+	/**
+	 * Reads the package data of these assets through the I/O dispatcher at the lowest priority without creating UObjects,
+	 * so a later RequestAsyncLoad mostly pays for deserialization. Reads are throttled by PrefetchBytesPerSecond and
+	 * paused while gameplay-priority requests are loading. Packages outside IoStore containers are skipped.
+	 */
+	static void PrefetchAssets(const TArray<FSoftObjectPath>& AssetPaths);
+	// Drops all prefetches that have not been issued yet.
+	static void CancelPrefetch();
+
 	template <typename AssetType>
 	static AssetType* GetAsset(const TSoftObjectPtr<AssetType>& AssetPointer,
 	                           FName ReferenceAssetTag = NAME_None, bool bKeepInMemory = false);
@@ -85,24 +164,82 @@ public:
 
 	// Thread safe way of adding a loaded asset to keep in memory.
 	void AddLoadedAsset(const UObject* Asset);
+	// Thread safe way of removing an asset added with AddLoadedAsset. Assets a pinned tag also keeps stay until it is unpinned.
+	void ReleaseLoadedAsset(const UObject* Asset);
 
 	// Logs all assets currently loaded and tracked by the asset manager.
 	static void DumpLoadedAssets();
 	void DumpReferenceLoadedAssets();
 	void DumpReferenceCounters();
+	// Logs tags currently pinned by adaptive pinning and the most recent pin/unpin decisions.
+	void DumpPinnedTags();
 
 	static FHyphenReferenceAssetLoadComplete& GetReferenceAssetLoadComplete();
+	static FHyphenReferenceTagReleased& GetReferenceTagReleased();
+
+	/**
+	 * Returns the load progress record of a reference tag, or nullptr if the tag was never requested.
+	 * Lock-free and allocation-free, safe to call from any thread. The returned record stays valid for the whole session.
+	 */
+	static const FHyphenTagLoadProgress* FindTagLoadProgress(FName ReferenceAssetTag);
+	// Returns the combined progress of several reference tags in [0, 1]. Safe to call from any thread.
+	static float GetTagsLoadProgress(TConstArrayView<FName> ReferenceAssetTags);
+
+	// Starts async loading of the configured warm-up assets. Called by the module as soon as the asset manager exists.
+	void StartWarmUp();
+	static const FHyphenWarmUpProgress& GetWarmUpProgress();
+
+	/**
+	 * Returns the LLM tag name that synchronous loads of a reference tag are attributed to, HyphenUtil/AssetManager/<ReferenceAssetTag>.
+	 * Falls back to HyphenUtil/AssetManager for untagged loads and once MaxReferenceTagLLMNames tags have their own entry.
+	 */
+	static FName GetReferenceTagLLMName(FName ReferenceAssetTag);
+
+	/**
+	 * Frees memory in tiers until available physical memory is back above LowMemoryAvailableBytes, with a full GC after each tier:
+	 * prefetch and pinned tags first, then tags nobody holds, then the objects of held tags loaded below LowMemoryCriticalPriority.
+	 * Evicted held tags keep their hold counts and are loaded again on their next hold.
+	 * Called from the platform memory trim and memory warning signals and the optional available memory poll. Game thread only.
+	 */
+	void RespondToLowMemory();
 
 protected:
 	UFUNCTION()
 	void OnReferenceAssetLoaded(const FHyphenReferenceAssetLoadInfo& AssetLoadInfo);
 
 private:
-	// Assets loaded and tracked by the asset manager.
+	friend struct FHyphenAssetManagerTestAccess;
+
+	struct FReferenceTagSlots
+	{
+		// Indices into ReferenceObjectPool owned by this tag.
+		TArray<int32> Slots;
+		TSet<FObjectKey> Objects;
+		// Highest priority of the loads that added objects, low memory flushes tags below LowMemoryCriticalPriority.
+		int32 Priority = MIN_int32;
+	};
+
+	// Adds objects to a reference tag, skipping ones the tag already holds.
+	void AddReferenceObjects(FName ReferenceAssetTag, TConstArrayView<UObject*> Objects);
+	// Records an object that was already in memory under a tag, so the tag's release still covers it.
+	void AddLoadedReferenceObject(FName ReferenceAssetTag, UObject* Object);
+	// Frees the pool slots of a reference tag.
+	void RemoveReferenceObjects(FName ReferenceAssetTag);
+	void EmptyReferenceObjects();
+
+	bool ContainsLoadedAsset(const UObject* Asset) const;
+	void RemoveLoadedAsset(const UObject* Asset);
+
+	// Assets loaded and tracked by the asset manager, swap-removed through LoadedAssetIndices.
 	UPROPERTY()
-	TSet<const UObject*> LoadedAssets;
+	TArray<const UObject*> LoadedAssets;
+	TMap<FObjectKey, int32> LoadedAssetIndices;
+
+	// Objects held by all reference tags in one contiguous array, so GC walks a single block instead of a set per tag.
 	UPROPERTY(VisibleAnywhere)
-	TMap<FName, FHyphenReferenceAssetObjects> ReferenceLoadedAssets;
+	TArray<const UObject*> ReferenceObjectPool;
+	TArray<int32> ReferenceObjectFreeSlots;
+	TMap<FName, FReferenceTagSlots> ReferenceLoadedAssets;
 	UPROPERTY(VisibleAnywhere)
 	TMap<FName, int32> ReferenceCounter;
 
@@ -111,6 +248,176 @@ private:
 
 	UPROPERTY()
 	FHyphenReferenceAssetLoadComplete OnReferenceAssetLoadComplete;
+	TArray<FHyphenReferenceAssetLoadInfo> PendingLoadCompletes;
+	FHyphenReferenceTagReleased OnReferenceTagReleased;
+	FTSTicker::FDelegateHandle LoadCompleteTickerHandle;
+
+	void OnReferenceAssetRequestCompleted(FHyphenReferenceAssetLoadInfo AssetLoadInfo, TSharedRef<TWeakPtr<FStreamableHandle>> HandleCell);
+	void OnReferenceAssetRequestCanceled(FName ReferenceAssetTag, int32 NumAssets);
+	// Records the loaded objects under the request's tag and runs its completion delegate once.
+	void FinishReferenceAssetLoad(const FHyphenReferenceAssetLoadInfo& AssetLoadInfo, TConstArrayView<UObject*> LoadedObjects);
+	bool BroadcastReferenceAssetLoadComplete(float DeltaTime);
+
+	// Game thread only, creates the progress record of a tag on first use.
+	static FHyphenTagLoadProgress* FindOrAddTagLoadProgress(FName ReferenceAssetTag);
+	void NoteReferenceAssetRequested(FName ReferenceAssetTag, int32 NumAssets);
+
+	struct FTagReloadStats
+	{
+		int32 ReleaseCount = 0;
+		int32 ReloadCount = 0;
+		int64 LastLoadBytes = 0;
+		double LastLoadSeconds = 0.0;
+		double LastRequestTime = 0.0;
+
+		// Reload frequency times load cost (bytes x seconds).
+		double GetScore() const { return ReloadCount * static_cast<double>(LastLoadBytes) * LastLoadSeconds; }
+	};
+
+	struct FPinnedTag
+	{
+		// Every object of the tag when it was pinned, shared objects are counted in PinnedAssets.
+		TArray<const UObject*> Objects;
+		int64 Bytes = 0;
+		double Score = 0.0;
+	};
+
+	struct FPinnedAsset
+	{
+		// Pinned tags holding the asset.
+		int32 PinCount = 0;
+		// Pinning added the asset to LoadedAssets, so the last unpin removes it.
+		bool bAddedByPin = false;
+	};
+
+	void BindWorldScopeDelegates();
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+	void OnPostWorldInitialization(UWorld* World, const UWorld::InitializationValues IVS);
+	void RemoveScopedReferences(FName ReferenceAssetTag);
+
+	bool TickPrefetch(float DeltaTime);
+	bool IsGameplayLoadInProgress();
+
+	void BindMemoryPressureDelegates();
+	void OnMemoryTrim();
+	bool TickMemoryPoll(float DeltaTime);
+	static bool IsAvailableMemoryLow(int64 ThresholdBytes);
+	void CollectGarbageForLowMemory(const TCHAR* Tier);
+	// Drops the objects of a held tag and remembers their paths, the hold counts stay as they are.
+	void EvictReferenceTag(FName ReferenceAssetTag);
+
+	void CollectLeakCandidates();
+	void OnPostGarbageCollectDetectLeaks();
+	void DetectLeaksFromCandidates();
+
+	bool IsReferenceTagResident(FName ReferenceAssetTag) const;
+	void TryPinReferenceTag(FName ReferenceAssetTag);
+	void UnpinReferenceTag(FName ReferenceAssetTag, const TCHAR* Reason);
+	bool TickPinnedTags(float DeltaTime);
+	void AddPinDecision(FString&& Decision);
+
+	// World-scoped hold counts per world.
+	TMap<TObjectKey<UWorld>, TMap<FName, int32>> WorldScopedReferences;
+	// World-scoped holds carried across a world cleanup, waiting for the next game world.
+	TMap<FName, int32> CarriedOverReferences;
+	TSet<FName> PendingCarryOverTags;
+	// Tags whose world-scoped holds are always carried over to the next world.
+	UPROPERTY(Config)
+	TArray<FName> TravelCarryOverTags;
+	FDelegateHandle WorldCleanupHandle;
+	FDelegateHandle PostWorldInitializationHandle;
+
+	// Reports objects that outlive FlushAllReferenceLoadedAssets after the next GC. Opt-in, the search is expensive.
+	UPROPERTY(Config)
+	bool bDetectLeaksAfterFlush = false;
+	TArray<FWeakObjectPtr> LeakCandidates;
+	FDelegateHandle LeakDetectionGCHandle;
+
+	// Low memory response runs until available physical memory is above this, 0 runs every tier on each signal.
+	UPROPERTY(Config)
+	int64 LowMemoryAvailableBytes = 256 * 1024 * 1024;
+	// Interval of polling available physical memory against LowMemoryAvailableBytes, 0 relies on the platform trim signal only.
+	UPROPERTY(Config)
+	float LowMemoryPollSeconds = 0.f;
+	// Signals within this long of the last response are ignored, so the previous GC gets a chance to return memory.
+	UPROPERTY(Config)
+	float LowMemoryCooldownSeconds = 5.f;
+	// Held tags whose loads were all below this priority are flushed in the last tier.
+	UPROPERTY(Config)
+	int32 LowMemoryCriticalPriority = FStreamableManager::DefaultAsyncLoadPriority;
+
+	double LastLowMemoryResponseTime = -DBL_MAX;
+	FDelegateHandle MemoryTrimHandle;
+	// Held tags whose objects low memory dropped, requested again on the next hold.
+	TMap<FName, FHyphenReferenceAssetLoadInfo> EvictedTags;
+	FTSTicker::FDelegateHandle MemoryPollTickerHandle;
+
+	struct FPrefetchChunk
+	{
+		FIoChunkId ChunkId;
+		uint64 Size = 0;
+	};
+
+	// Upper bound of prefetch read bandwidth.
+	UPROPERTY(Config)
+	int64 PrefetchBytesPerSecond = 32 * 1024 * 1024;
+	// Prefetch pauses while requests at or above this priority are loading.
+	UPROPERTY(Config)
+	int32 PrefetchPauseMinPriority = FStreamableManager::DefaultAsyncLoadPriority;
+	// Prefetch reads that may be in flight at once.
+	UPROPERTY(Config)
+	int32 MaxPrefetchReadsInFlight = 4;
+
+	TArray<FPrefetchChunk> PrefetchQueue;
+	int32 PrefetchQueueHead = 0;
+	double PrefetchBudgetBytes = 0.0;
+	std::atomic<int32> PrefetchReadsInFlight{0};
+	// Loads at or above PrefetchPauseMinPriority, finished ones are pruned whenever one is added or prefetch checks them.
+	TArray<TWeakPtr<FStreamableHandle>> GameplayLoadHandles;
+	FTSTicker::FDelegateHandle PrefetchTickerHandle;
+
+	// Bytes of tag contents that adaptive pinning may keep in LoadedAssets, 0 disables pinning.
+	UPROPERTY(Config)
+	int64 PinMemoryCapBytes = 0;
+	// Reloads after a release before a tag is considered for pinning.
+	UPROPERTY(Config)
+	int32 PinMinReloadCount = 3;
+	// Pinned tags that are not requested for this long are unpinned.
+	UPROPERTY(Config)
+	float PinColdSeconds = 300.f;
+
+	TMap<FName, FTagReloadStats> TagReloadStats;
+	TMap<FName, FPinnedTag> PinnedTags;
+	TMap<FObjectKey, FPinnedAsset> PinnedAssets;
+	int64 PinnedBytes = 0;
+	TArray<FString> PinDecisions;
+	FTSTicker::FDelegateHandle PinTickerHandle;
+
+	struct FWarmUpRequest
+	{
+		FName AssetTag;
+		int32 NumAssets = 0;
+		TSharedPtr<FStreamableHandle> Handle;
+		bool bLoaded = false;
+		bool bReleased = false;
+	};
+
+	void OnWarmUpRequestLoaded(int32 RequestIndex);
+	void OnWarmUpMapLoaded(UWorld* LoadedWorld);
+	void ReleaseWarmUpRequest(FWarmUpRequest& Request);
+
+	// Assets to start loading during startup, held by their tag until the first map is loaded.
+	UPROPERTY(Config)
+	TArray<FHyphenReferenceAssetLoadInfo> WarmUpAssets;
+	// Reference tag used for warm-up entries without their own AssetTag.
+	UPROPERTY(Config)
+	FName WarmUpReferenceTag = TEXT("HyphenWarmUp");
+
+	TArray<FWarmUpRequest> WarmUpRequests;
+	FDelegateHandle WarmUpMapLoadedHandle;
+	bool bWarmUpMapLoaded = false;
+
+	static FHyphenWarmUpProgress WarmUpProgress;
 };
 
 template <typename AssetType>
@@ -126,14 +433,24 @@ AssetType* UHyphenAssetManager::GetAsset(const TSoftObjectPtr<AssetType>& AssetP
 		LoadedAsset = AssetPointer.Get();
 		if (!LoadedAsset)
 		{
+			const double RequestTime = FPlatformTime::Seconds();
+			if (ReferenceAssetTag != NAME_None)
+			{
+				Get().NoteReferenceAssetRequested(ReferenceAssetTag, 1);
+			}
+			HYPHEN_LLM_SCOPE_REFERENCE_TAG(ReferenceAssetTag);
 			LoadedAsset = AssetPointer.LoadSynchronous();
 			ensureAlwaysMsgf(LoadedAsset, TEXT("Failed to load asset [%s]"), *AssetPointer.ToString());
 
 			if (ReferenceAssetTag != NAME_None)
 			{
-				Get().OnReferenceAssetLoaded(FHyphenReferenceAssetLoadInfo{ReferenceAssetTag, {AssetPointer.ToSoftObjectPath()}, 0, FStreamableDelegate()});
+				Get().OnReferenceAssetLoaded(FHyphenReferenceAssetLoadInfo{ReferenceAssetTag, {AssetPointer.ToSoftObjectPath()}, 0, FStreamableDelegate(), RequestTime});
 			}
 		}
+		else if (ReferenceAssetTag != NAME_None)
+		{
+			Get().AddLoadedReferenceObject(ReferenceAssetTag, Cast<UObject>(LoadedAsset));
+		}
 
 		if (LoadedAsset && bKeepInMemory)
 		{
@@ -158,8 +475,23 @@ TSubclassOf<AssetType> UHyphenAssetManager::GetSubclass(const TSoftClassPtr<Asse
 		LoadedSubclass = ClassPointer.Get();
 		if (!LoadedSubclass)
 		{
+			const double RequestTime = FPlatformTime::Seconds();
+			if (ReferenceAssetTag != NAME_None)
+			{
+				Get().NoteReferenceAssetRequested(ReferenceAssetTag, 1);
+			}
+			HYPHEN_LLM_SCOPE_REFERENCE_TAG(ReferenceAssetTag);
 			LoadedSubclass = ClassPointer.LoadSynchronous();
 			ensureAlwaysMsgf(LoadedSubclass, TEXT("Failed to load asset class [%s]"), *ClassPointer.ToString());
+
+			if (ReferenceAssetTag != NAME_None)
+			{
+				Get().OnReferenceAssetLoaded(FHyphenReferenceAssetLoadInfo{ReferenceAssetTag, {AssetPath}, 0, FStreamableDelegate(), RequestTime});
+			}
+		}
+		else if (ReferenceAssetTag != NAME_None)
+		{
+			Get().AddLoadedReferenceObject(ReferenceAssetTag, Cast<UObject>(LoadedSubclass));
 		}
 
 		if (LoadedSubclass && bKeepInMemory)
@@ -0,0 +1,26 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+namespace HyphenUtil
+{
+	struct FGameplayTagBatchResult
+	{
+		// Tags in the order of the input strings, invalid where the string is not a registered tag.
+		TArray<FGameplayTag> Tags;
+		// Indices of the input strings that did not resolve.
+		TArray<int32> FailedIndices;
+	};
+
+	/**
+	 * Converts many tag strings at once, e.g. for CSV or JSON import.
+	 *
+	 * Spaces are ignored like in GetGameplayTagFromString. Identical strings are resolved once, and the unique names are
+	 * resolved in parallel through FGameplayTagIndex. Unknown tags are returned in FailedIndices without reporting errors.
+	 */
+	HYPHENUTIL_API FGameplayTagBatchResult GetGameplayTagsFromStrings(TConstArrayView<FStringView> TagNames);
+	HYPHENUTIL_API FGameplayTagBatchResult GetGameplayTagsFromStrings(TConstArrayView<FString> TagNames);
+}
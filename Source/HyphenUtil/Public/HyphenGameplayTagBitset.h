@@ -0,0 +1,262 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+// Number of tags a FGameplayTagBitset keeps inline, a multiple of 128. Tags past it are kept in words on the heap, which costs
+// an allocation and a scalar loop per query. Projects with more tags can raise it in their target rules.
+#ifndef HYPHENUTIL_TAG_BITSET_BITS
+#define HYPHENUTIL_TAG_BITSET_BITS 1024
+#endif
+
+namespace HyphenUtil
+{
+	/**
+	 * Bitset over the dense indices of FGameplayTagIndex, fixed width inline and growing on the heap past it.
+	 * Queries compare four inline words per instruction and never touch the tag manager.
+	 */
+	class FGameplayTagBitset
+	{
+	public:
+		static constexpr int32 NumInlineBits = HYPHENUTIL_TAG_BITSET_BITS;
+		static constexpr int32 NumInlineWords = NumInlineBits / 32;
+		static_assert(NumInlineBits > 0 && NumInlineBits % 128 == 0, "HYPHENUTIL_TAG_BITSET_BITS must be a multiple of 128");
+
+		void Set(int32 Index)
+		{
+			check(Index >= 0);
+			if (Index < NumInlineBits)
+			{
+				Words[Index >> 5] |= 1u << (Index & 31);
+				return;
+			}
+			const int32 OverflowIndex = (Index >> 5) - NumInlineWords;
+			if (OverflowIndex >= OverflowWords.Num())
+			{
+				OverflowWords.SetNumZeroed(OverflowIndex + 1);
+			}
+			OverflowWords[OverflowIndex] |= 1u << (Index & 31);
+		}
+		bool Test(int32 Index) const
+		{
+			if (Index < NumInlineBits)
+			{
+				return Index >= 0 && (Words[Index >> 5] & (1u << (Index & 31))) != 0;
+			}
+			return (GetOverflowWord((Index >> 5) - NumInlineWords) & (1u << (Index & 31))) != 0;
+		}
+		void Reset()
+		{
+			FMemory::Memzero(Words);
+			OverflowWords.Reset();
+		}
+
+		bool IsEmpty() const
+		{
+			VectorRegister4Int Any = GlobalVectorConstants::IntZero;
+			for (int32 WordIndex = 0; WordIndex < NumInlineWords; WordIndex += 4)
+			{
+				Any = VectorIntOr(Any, VectorIntLoadAligned(&Words[WordIndex]));
+			}
+			if (!IsZero(Any))
+			{
+				return false;
+			}
+			for (const uint32 Word : OverflowWords)
+			{
+				if (Word != 0)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Returns true if any bit is set in both bitsets.
+		bool Intersects(const FGameplayTagBitset& Other) const
+		{
+			VectorRegister4Int Any = GlobalVectorConstants::IntZero;
+			for (int32 WordIndex = 0; WordIndex < NumInlineWords; WordIndex += 4)
+			{
+				Any = VectorIntOr(Any, VectorIntAnd(VectorIntLoadAligned(&Words[WordIndex]), VectorIntLoadAligned(&Other.Words[WordIndex])));
+			}
+			if (!IsZero(Any))
+			{
+				return true;
+			}
+			const int32 NumOverflowWords = FMath::Min(OverflowWords.Num(), Other.OverflowWords.Num());
+			for (int32 WordIndex = 0; WordIndex < NumOverflowWords; WordIndex++)
+			{
+				if ((OverflowWords[WordIndex] & Other.OverflowWords[WordIndex]) != 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Returns true if every bit set in Other is also set in this bitset.
+		bool Contains(const FGameplayTagBitset& Other) const
+		{
+			VectorRegister4Int Missing = GlobalVectorConstants::IntZero;
+			for (int32 WordIndex = 0; WordIndex < NumInlineWords; WordIndex += 4)
+			{
+				// VectorIntAndNot(A, B) is ~A & B
+				Missing = VectorIntOr(Missing, VectorIntAndNot(VectorIntLoadAligned(&Words[WordIndex]), VectorIntLoadAligned(&Other.Words[WordIndex])));
+			}
+			if (!IsZero(Missing))
+			{
+				return false;
+			}
+			for (int32 WordIndex = 0; WordIndex < Other.OverflowWords.Num(); WordIndex++)
+			{
+				if ((Other.OverflowWords[WordIndex] & ~GetOverflowWord(WordIndex)) != 0)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		void Append(const FGameplayTagBitset& Other)
+		{
+			for (int32 WordIndex = 0; WordIndex < NumInlineWords; WordIndex += 4)
+			{
+				VectorIntStoreAligned(VectorIntOr(VectorIntLoadAligned(&Words[WordIndex]), VectorIntLoadAligned(&Other.Words[WordIndex])), &Words[WordIndex]);
+			}
+			if (Other.OverflowWords.Num() > OverflowWords.Num())
+			{
+				OverflowWords.SetNumZeroed(Other.OverflowWords.Num());
+			}
+			for (int32 WordIndex = 0; WordIndex < Other.OverflowWords.Num(); WordIndex++)
+			{
+				OverflowWords[WordIndex] |= Other.OverflowWords[WordIndex];
+			}
+		}
+
+		bool operator==(const FGameplayTagBitset& Other) const
+		{
+			if (FMemory::Memcmp(Words, Other.Words, sizeof(Words)) != 0)
+			{
+				return false;
+			}
+			// Overflow words past the end of the other bitset count as empty
+			const int32 NumOverflowWords = FMath::Max(OverflowWords.Num(), Other.OverflowWords.Num());
+			for (int32 WordIndex = 0; WordIndex < NumOverflowWords; WordIndex++)
+			{
+				if (GetOverflowWord(WordIndex) != Other.GetOverflowWord(WordIndex))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+		bool operator!=(const FGameplayTagBitset& Other) const
+		{
+			return !(*this == Other);
+		}
+
+		// Calls Function with the index of every set bit.
+		template <typename FunctionType>
+		void ForEachSetBit(FunctionType&& Function) const
+		{
+			for (int32 WordIndex = 0; WordIndex < NumInlineWords; WordIndex++)
+			{
+				for (uint32 Word = Words[WordIndex]; Word != 0; Word &= Word - 1)
+				{
+					Function(WordIndex * 32 + static_cast<int32>(FMath::CountTrailingZeros(Word)));
+				}
+			}
+			for (int32 WordIndex = 0; WordIndex < OverflowWords.Num(); WordIndex++)
+			{
+				for (uint32 Word = OverflowWords[WordIndex]; Word != 0; Word &= Word - 1)
+				{
+					Function(NumInlineBits + WordIndex * 32 + static_cast<int32>(FMath::CountTrailingZeros(Word)));
+				}
+			}
+		}
+
+	private:
+		static bool IsZero(const VectorRegister4Int& Vector)
+		{
+			return VectorMaskBits(VectorCast4IntTo4Float(VectorIntCompareEQ(Vector, GlobalVectorConstants::IntZero))) == 0xF;
+		}
+
+		uint32 GetOverflowWord(int32 WordIndex) const
+		{
+			return OverflowWords.IsValidIndex(WordIndex) ? OverflowWords[WordIndex] : 0;
+		}
+
+		alignas(16) uint32 Words[NumInlineWords] = {};
+		// Words for the bits past NumInlineBits, only as many as the highest set bit needs
+		TArray<uint32> OverflowWords;
+	};
+
+	/**
+	 * Companion of FGameplayTagContainer for hot query loops, with the same query semantics.
+	 * Keeps the explicit tags and the tags with their parents as two bitsets, so HasAny and HasAll are a few SIMD
+	 * instructions instead of walking tag arrays. Valid tags that are not in FGameplayTagIndex yet, e.g. ones added during a
+	 * source update, are kept in a FGameplayTagContainer instead, and queries involving such a container use its semantics.
+	 */
+	class HYPHENUTIL_API FGameplayTagBitContainer
+	{
+	public:
+		FGameplayTagBitContainer() = default;
+		explicit FGameplayTagBitContainer(const FGameplayTagContainer& Container);
+
+		// Resolves the strings through GetGameplayTagsFromStrings, unknown tags are dropped.
+		static FGameplayTagBitContainer FromStrings(TConstArrayView<FStringView> TagNames);
+
+		// Returns false for an invalid tag, which is ignored.
+		bool AddTag(const FGameplayTag& Tag);
+		void AppendTags(const FGameplayTagContainer& Container);
+		void Reset();
+		FGameplayTagContainer ToContainer() const;
+
+		bool HasTag(const FGameplayTag& Tag) const;
+		bool HasTagExact(const FGameplayTag& Tag) const;
+		// Same as HasTag with an index from FGameplayTagIndex::FindDenseIndex, cheaper when the index is looked up once.
+		bool HasTag(int32 DenseIndex) const { return TagsWithParents.Test(DenseIndex) || (!UnindexedTags.IsEmpty() && HasUnindexedTag(DenseIndex, false)); }
+		bool HasTagExact(int32 DenseIndex) const { return ExplicitTags.Test(DenseIndex) || (!UnindexedTags.IsEmpty() && HasUnindexedTag(DenseIndex, true)); }
+
+		bool HasAny(const FGameplayTagBitContainer& Other) const
+		{
+			return IsIndexed(Other) ? TagsWithParents.Intersects(Other.ExplicitTags) : ToContainer().HasAny(Other.ToContainer());
+		}
+		bool HasAnyExact(const FGameplayTagBitContainer& Other) const
+		{
+			return IsIndexed(Other) ? ExplicitTags.Intersects(Other.ExplicitTags) : ToContainer().HasAnyExact(Other.ToContainer());
+		}
+		bool HasAll(const FGameplayTagBitContainer& Other) const
+		{
+			return IsIndexed(Other) ? TagsWithParents.Contains(Other.ExplicitTags) : ToContainer().HasAll(Other.ToContainer());
+		}
+		bool HasAllExact(const FGameplayTagBitContainer& Other) const
+		{
+			return IsIndexed(Other) ? ExplicitTags.Contains(Other.ExplicitTags) : ToContainer().HasAllExact(Other.ToContainer());
+		}
+		bool IsEmpty() const { return ExplicitTags.IsEmpty() && UnindexedTags.IsEmpty(); }
+
+		// The bitsets only hold indexed tags, see GetUnindexedTags for the rest.
+		const FGameplayTagBitset& GetExplicitTags() const { return ExplicitTags; }
+		const FGameplayTagBitset& GetTagsWithParents() const { return TagsWithParents; }
+		const FGameplayTagContainer& GetUnindexedTags() const { return UnindexedTags; }
+
+		bool operator==(const FGameplayTagBitContainer& Other) const
+		{
+			return IsIndexed(Other) ? ExplicitTags == Other.ExplicitTags : ToContainer() == Other.ToContainer();
+		}
+		bool operator!=(const FGameplayTagBitContainer& Other) const { return !(*this == Other); }
+
+	private:
+		// Returns true if neither container has unindexed tags, so the bitsets answer queries on their own.
+		bool IsIndexed(const FGameplayTagBitContainer& Other) const { return UnindexedTags.IsEmpty() && Other.UnindexedTags.IsEmpty(); }
+		bool HasUnindexedTag(int32 DenseIndex, bool bExact) const;
+
+		FGameplayTagBitset ExplicitTags;
+		FGameplayTagBitset TagsWithParents;
+		FGameplayTagContainer UnindexedTags;
+	};
+}
@@ -0,0 +1,148 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Containers/Ticker.h"
+#include <atomic>
+
+namespace HyphenUtil
+{
+	/**
+	 * Resolved combinations of a parent tag and a child name, so repeated combines are a single hash probe.
+	 * Safe to use from any thread. Emptied whenever the gameplay tag tree changes.
+	 */
+	class HYPHENUTIL_API FGameplayTagCache
+	{
+	public:
+		static FGameplayTagCache& Get();
+
+		// Returns true and the cached tag if ParentTagName.ChildName was resolved before.
+		bool FindCombined(FName ParentTagName, FName ChildName, FGameplayTag& OutTag) const;
+		void AddCombined(FName ParentTagName, FName ChildName, const FGameplayTag& Tag);
+		void Invalidate();
+		int32 Num() const;
+
+	private:
+		mutable FRWLock Lock;
+		TMap<TPair<FName, FName>, FGameplayTag> CombinedTags;
+	};
+
+	/**
+	 * Every registered tag by its full name and by its parent tag name and simple name, built from the gameplay tag tree.
+	 * Combining a parent with a child is one hash probe per child segment, without building the combined name.
+	 * Lookups probe open addressing tables without locks and are safe from any thread. New tags are inserted in place,
+	 * the tables are only replaced when they are full or tags were removed. Each reading thread publishes the epoch its lookup
+	 * started in to a slot of its own, replaced tables are freed on a tick once no lookup from before the replacement is left.
+	 */
+	class HYPHENUTIL_API FGameplayTagIndex
+	{
+	public:
+		static FGameplayTagIndex& Get();
+		~FGameplayTagIndex();
+
+		// Returns true and the tag if TagName is a registered tag.
+		bool FindTag(FName TagName, FGameplayTag& OutTag) const;
+		// Returns true and the tag if ParentTagName has the child ChildName, which may have several segments. Root tags have the parent NAME_None.
+		bool FindChild(FName ParentTagName, FName ChildName, FGameplayTag& OutTag) const;
+		bool FindChild(FName ParentTagName, FStringView ChildName, FGameplayTag& OutTag) const;
+		// Indexes tags added since the last update, or rebuilds the live tags if tags were removed. Game thread only.
+		void Update();
+		/**
+		 * Update does nothing between these. A source that knows which tags it adds, e.g. FGameplayTagRegistrationBatch,
+		 * passes them to EndSourceUpdate, so only those tags and their new parents are indexed. Game thread only.
+		 */
+		void BeginSourceUpdate();
+		void EndSourceUpdate(TConstArrayView<FGameplayTag> AddedTags);
+		// Unpublishes the snapshot and frees it once the lookups in flight finished, lookups find nothing afterwards. Called on module shutdown.
+		void Reset();
+		int32 Num() const;
+
+		/**
+		 * Every indexed tag also has a dense index, used as its bit in FGameplayTagBitset.
+		 * Dense indices are never reused, removed tags keep theirs, so bitsets stay valid for the lifetime of the process.
+		 */
+		int32 FindDenseIndex(const FGameplayTag& Tag) const;
+		// Calls Visitor with the dense index of Tag and then of each of its parents, until Visitor returns false. Returns false if Tag is not indexed.
+		bool ForEachDenseIndexWithParents(const FGameplayTag& Tag, TFunctionRef<bool(int32)> Visitor) const;
+		FGameplayTag GetDenseTag(int32 DenseIndex) const;
+		int32 NumDense() const;
+
+	private:
+		struct FTagEntry
+		{
+			FGameplayTag Tag;
+			FName ParentTagName;
+			FName SimpleTagName;
+			int32 DenseIndex = INDEX_NONE;
+			int32 ParentDenseIndex = INDEX_NONE;
+		};
+
+		// Fixed-capacity open addressing tables of entries. Only the game thread inserts, readers probe with acquire loads.
+		struct FSnapshot
+		{
+			explicit FSnapshot(int32 InCapacity);
+
+			const FTagEntry* FindTag(FName TagName) const;
+			const FTagEntry* FindChild(FName ParentTagName, FName SimpleTagName) const;
+			const FTagEntry* FindDense(FName TagName) const;
+			const FTagEntry* GetDense(int32 DenseIndex) const;
+			// Inserts Entry as a live tag, returns false if it already is one.
+			bool AddLive(const FTagEntry& Entry);
+			void AddDense(const FTagEntry& Entry);
+
+			const int32 Capacity;
+			const int32 MaxEntries;
+			// Live tags by full name and by parent and simple name
+			TUniquePtr<std::atomic<const FTagEntry*>[]> Tags;
+			TUniquePtr<std::atomic<const FTagEntry*>[]> Children;
+			// Every tag indexed so far, by full name and by dense index
+			TUniquePtr<std::atomic<const FTagEntry*>[]> DenseNames;
+			TUniquePtr<std::atomic<const FTagEntry*>[]> DenseEntries;
+			std::atomic<int32> NumTags{0};
+		};
+
+		// Pins the published snapshot for the lifetime of the scope.
+		class FReadScope;
+
+		// Epoch the lookup of a thread started in, 0 while it is not reading. One cache line each, so readers never write a shared one.
+		struct alignas(PLATFORM_CACHE_LINE_SIZE) FReaderSlot
+		{
+			std::atomic<uint64> Epoch{0};
+			std::atomic<bool> bClaimed{false};
+		};
+		static constexpr int32 MaxReaderSlots = 256;
+
+		struct FRetiredSnapshot
+		{
+			const FSnapshot* Snapshot = nullptr;
+			// Epoch after the snapshot was unpublished, lookups that started in it or later cannot see the snapshot
+			uint64 RetireEpoch = 0;
+		};
+
+		// Indexes NewTags and their parents that are not live yet. With LiveTags, the live tables are rebuilt from them.
+		void IndexTags(TConstArrayView<FGameplayTag> NewTags, const FGameplayTagContainer* LiveTags);
+		static bool FindChild(const FSnapshot& CurrentSnapshot, FName ParentTagName, FStringView ChildName, FGameplayTag& OutTag);
+		// Returns a free reader slot for the calling thread, or nullptr if all are taken.
+		FReaderSlot* ClaimReaderSlot() const;
+		void RetireSnapshot(const FSnapshot* ReplacedSnapshot);
+		// Frees the retired snapshots no lookup can still be using. Returns true if none are left.
+		bool FreeRetiredSnapshots();
+		bool TickRetiredSnapshots(float DeltaTime);
+
+		std::atomic<FSnapshot*> Snapshot{nullptr};
+		// Owns every entry, by dense index. Snapshots only point to them, so replacing the tables does not copy entries.
+		TArray<TUniquePtr<FTagEntry>> Entries;
+		std::atomic<int32> NumEntries{0};
+		int32 SourceUpdateDepth = 0;
+		// Advanced every time a snapshot is unpublished
+		std::atomic<uint64> Epoch{1};
+		mutable FReaderSlot ReaderSlots[MaxReaderSlots];
+		// Lookups in flight on threads that found no free slot. While any is counted, nothing is freed.
+		mutable std::atomic<int32> OverflowReaders{0};
+		// Replaced snapshots a reader may still be using
+		TArray<FRetiredSnapshot> RetiredSnapshots;
+		FTSTicker::FDelegateHandle RetiredSnapshotsTickerHandle;
+	};
+}
@@ -0,0 +1,101 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include <atomic>
+
+namespace HyphenUtil
+{
+	namespace Private
+	{
+		// Tag name with spaces stripped, validated and hashed at compile time. Built by HYPHEN_TAG.
+		template <int32 N>
+		struct TTagLiteral
+		{
+			TCHAR Name[N] = {};
+			int32 Len = 0;
+			// FNV-1a of the lower case name, tag names are case insensitive
+			uint64 Hash = 14695981039346656037ull;
+			bool bValid = false;
+
+			explicit constexpr TTagLiteral(const TCHAR (&Text)[N])
+			{
+				for (int32 Index = 0; Index + 1 < N; Index++)
+				{
+					if (Text[Index] != TEXT(' '))
+					{
+						Name[Len++] = Text[Index];
+					}
+				}
+
+				bValid = Len > 0 && Name[0] != TEXT('.') && Name[Len - 1] != TEXT('.');
+				for (int32 Index = 0; Index < Len; Index++)
+				{
+					const TCHAR Character = Name[Index];
+					const bool bEmptySegment = Character == TEXT('.') && Index + 1 < Len && Name[Index + 1] == TEXT('.');
+					const bool bInvalidCharacter = Character == TEXT('"') || Character == TEXT('\'') || Character == TEXT(',')
+						|| Character == TEXT('\t') || Character == TEXT('\r') || Character == TEXT('\n');
+					bValid = bValid && !bEmptySegment && !bInvalidCharacter;
+
+					const TCHAR LowerCharacter = Character >= TEXT('A') && Character <= TEXT('Z') ? Character - TEXT('A') + TEXT('a') : Character;
+					Hash = (Hash ^ static_cast<uint64>(LowerCharacter)) * 1099511628211ull;
+				}
+			}
+		};
+
+		/**
+		 * Tag of one literal, resolved by the first caller that finds it registered.
+		 * Later calls are an acquire load. A tag that is not registered yet is looked up again on the next call.
+		 */
+		class HYPHENUTIL_API FTagLiteralHandle
+		{
+		public:
+			FGameplayTag Get(const TCHAR* TagName, int32 Len)
+			{
+				if (State.load(std::memory_order_acquire) == Resolved)
+				{
+					checkSlow(FStringView(TagName, Len).Equals(FStringView(ResolvedName, ResolvedLen), ESearchCase::IgnoreCase));
+					return Tag;
+				}
+				return Resolve(TagName, Len);
+			}
+
+		private:
+			enum : uint8
+			{
+				Unresolved,
+				Resolving,
+				Resolved,
+			};
+
+			FGameplayTag Resolve(const TCHAR* TagName, int32 Len);
+
+			std::atomic<uint8> State{Unresolved};
+			FGameplayTag Tag;
+			// Literals share a handle by hash, kept to catch collisions in slow guard builds
+			const TCHAR* ResolvedName = nullptr;
+			int32 ResolvedLen = 0;
+		};
+
+		// One handle per distinct literal in the module, whichever file or function it is written in.
+		template <uint64 Hash>
+		struct TTagLiteralHandle
+		{
+			static inline FTagLiteralHandle Handle;
+		};
+	}
+}
+
+/**
+ * Gameplay tag from a string literal, e.g. HYPHEN_TAG("Ability.Attack.Melee").
+ * Spaces are stripped and the name is validated at compile time, the tag is resolved once on first use from any thread.
+ */
+#define HYPHEN_TAG(TagName) \
+	([]() -> FGameplayTag \
+	{ \
+		static constexpr ::HyphenUtil::Private::TTagLiteral<UE_ARRAY_COUNT(TEXT(TagName))> Literal(TEXT(TagName)); \
+		static_assert(Literal.bValid, "HYPHEN_TAG(\"" TagName "\") is not a valid gameplay tag name"); \
+		return ::HyphenUtil::Private::TTagLiteralHandle<Literal.Hash>::Handle.Get(Literal.Name, Literal.Len); \
+	}())
@@ -0,0 +1,44 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace HyphenUtil
+{
+	/**
+	 * Collects generated tag names and registers them in one batch, so the tag tree handles them once.
+	 *
+	 * Before native tags are done, the tags are added as native tags and the engine builds the tree with all of them.
+	 * Later, they are added with a single tree changed broadcast instead of one per tag. Combinations are filled into
+	 * FGameplayTagCache once their tags exist. Game thread only.
+	 */
+	class HYPHENUTIL_API FGameplayTagRegistrationBatch
+	{
+	public:
+		explicit FGameplayTagRegistrationBatch(const FString& InDevComment = TEXT("Generated by HyphenUtil"));
+
+		void AddTag(FName TagName);
+		// Adds ParentTagName.ChildName for every parent and child.
+		void AddCombinations(TConstArrayView<FName> ParentTagNames, TConstArrayView<FName> ChildNames);
+		int32 Num() const { return TagNames.Num(); }
+
+		// Registers the collected tags that do not exist yet and empties the batch. Returns the number of tags registered.
+		int32 Register();
+
+	private:
+		struct FCombination
+		{
+			FName ParentTagName;
+			FName ChildName;
+			FName TagName;
+		};
+
+		FString DevComment;
+		TSet<FName> TagNames;
+		TArray<FCombination> Combinations;
+	};
+
+	// Unregisters the tags batches added after native tags were done. Called on module shutdown.
+	void ReleaseGeneratedGameplayTags();
+}
@@ -0,0 +1,52 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/Widget.h"
+#include "HyphenLazyWidget.generated.h"
+
+class SHyphenLazyContent;
+class UUserWidget;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHyphenLazyContentConstructed, UUserWidget*, Content);
+
+/**
+ * Placeholder that creates its content widget only after it is first painted, i.e. scrolled, expanded or switched into view.
+ * Pending constructions of all lazy widgets share one per-frame budget (HyphenUtil.LazyWidgetBudgetMs),
+ * so screens with thousands of entries open without building their off-screen parts.
+ */
+UCLASS()
+class HYPHENUTIL_API UHyphenLazyWidget : public UWidget
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "HyphenUtil|LazyWidget")
+	TSubclassOf<UUserWidget> ContentClass;
+	// Desired size until the content exists, so containers can lay out and cull the placeholder.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "HyphenUtil|LazyWidget")
+	FVector2D PlaceholderSize = FVector2D::ZeroVector;
+
+	UPROPERTY(BlueprintAssignable, Category = "HyphenUtil|LazyWidget")
+	FHyphenLazyContentConstructed OnContentConstructed;
+
+	// Returns the content widget, or nullptr while it has not been constructed.
+	UFUNCTION(BlueprintPure, Category = "HyphenUtil|LazyWidget")
+	UUserWidget* GetContent() const { return Content; }
+	// Constructs the content right away, e.g. for a widget that has to be measured before it is shown.
+	UFUNCTION(BlueprintCallable, Category = "HyphenUtil|LazyWidget")
+	void ConstructContentNow();
+
+	virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+
+protected:
+	virtual TSharedRef<SWidget> RebuildWidget() override;
+
+private:
+	void OnFirstPaint();
+
+	UPROPERTY(Transient)
+	TObjectPtr<UUserWidget> Content;
+	TSharedPtr<SHyphenLazyContent> LazyContent;
+};
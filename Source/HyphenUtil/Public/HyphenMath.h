@@ -0,0 +1,86 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/ParallelFor.h"
+
+namespace HyphenUtil
+{
+	enum class ENormalDistributionPrecision : uint8
+	{
+		// Same exp as the scalar UHyphenUtilLibrary::NormalDistribution.
+		Precise,
+		// Polynomial exp2, relative error below NormalDistributionFastMaxRelativeError. Results below 2^-126 * Coefficient become 0.
+		Fast,
+	};
+
+	constexpr float NormalDistributionFastMaxRelativeError = 2e-5f;
+
+	/**
+	 * Batch version of UHyphenUtilLibrary::NormalDistribution, Coefficient * exp(-(X - Mean)^2 / (2 * StandardDeviation^2)) for every X.
+	 * Evaluates four samples per instruction. OutValues must have the same number of elements as X, and may be the same array.
+	 */
+	HYPHENUTIL_API void NormalDistributionBatch(float Mean, float StandardDeviation, float Coefficient, TConstArrayView<float> X, TArrayView<float> OutValues,
+	                                            ENormalDistributionPrecision Precision = ENormalDistributionPrecision::Precise);
+
+	// Sigmas of cached kernels are rounded to multiples of this step.
+	constexpr float GaussianKernelSigmaStep = 1.f / 256.f;
+	// Number of cached kernels, the least recently built one is dropped beyond it.
+	constexpr int32 MaxCachedGaussianKernels = 256;
+
+	using FGaussianKernelRef = TSharedRef<const TArray<float>, ESPMode::ThreadSafe>;
+
+	/**
+	 * Normalized 1D Gaussian kernel of 2 * Radius + 1 weights summing to 1, centered at index Radius.
+	 * Sigma is rounded to a multiple of GaussianKernelSigmaStep and kernels are cached per rounded sigma and radius, a dropped
+	 * kernel stays valid while it is referenced. A radius of about 3 * Sigma covers the distribution. Sigma of 0 or less gives
+	 * the identity kernel, NaN or infinite sigma is rejected with an ensure and gives it as well. Safe to call from any thread.
+	 */
+	HYPHENUTIL_API FGaussianKernelRef GetGaussianKernel(float Sigma, int32 Radius);
+
+	// Separable 2D Gaussian kernel, the weight at an offset from the center is the product of the row and column weights.
+	struct FGaussianKernel2D
+	{
+		FGaussianKernelRef Rows;
+		FGaussianKernelRef Columns;
+
+		int32 GetRadiusX() const { return Rows->Num() / 2; }
+		int32 GetRadiusY() const { return Columns->Num() / 2; }
+		// Returns the weight at OffsetX, OffsetY from the center, 0 outside of the kernel.
+		float GetWeight(int32 OffsetX, int32 OffsetY) const
+		{
+			return Rows->IsValidIndex(OffsetX + GetRadiusX()) && Columns->IsValidIndex(OffsetY + GetRadiusY())
+				? (*Rows)[OffsetX + GetRadiusX()] * (*Columns)[OffsetY + GetRadiusY()]
+				: 0.f;
+		}
+	};
+
+	// 2D kernel from the cached 1D kernels of SigmaX and RadiusX along rows and SigmaY and RadiusY along columns.
+	HYPHENUTIL_API FGaussianKernel2D GetGaussianKernel2D(float SigmaX, float SigmaY, int32 RadiusX, int32 RadiusY);
+
+	/**
+	 * Blurs a row major Width x Height grid with the separable Gaussian kernel of Sigma and Radius, rows first and then columns.
+	 * Cells outside of the grid repeat the nearest edge cell. OutGrid may be the same array as Grid. Scratch keeps the
+	 * intermediate grid, reusing it across frames avoids allocating. Large grids are convolved with ParallelFor.
+	 */
+	HYPHENUTIL_API void GaussianBlur(TConstArrayView<float> Grid, int32 Width, int32 Height, float Sigma, int32 Radius, TArrayView<float> OutGrid, TArray<float>& Scratch);
+	// Same as above with a 2D kernel, e.g. for a different spread along rows and columns.
+	HYPHENUTIL_API void GaussianBlur(TConstArrayView<float> Grid, int32 Width, int32 Height, const FGaussianKernel2D& Kernel, TArrayView<float> OutGrid, TArray<float>& Scratch);
+
+	// Convolves every row of a row major Width x Height grid with Kernel, which has an odd number of weights. OutGrid must not be Grid.
+	HYPHENUTIL_API void ConvolveRows(TConstArrayView<float> Grid, int32 Width, int32 Height, TConstArrayView<float> Kernel, TArrayView<float> OutGrid);
+	// Convolves every column of a row major Width x Height grid with Kernel, which has an odd number of weights. OutGrid must not be Grid.
+	HYPHENUTIL_API void ConvolveColumns(TConstArrayView<float> Grid, int32 Width, int32 Height, TConstArrayView<float> Kernel, TArrayView<float> OutGrid);
+
+	// Number of values drawn from one stream by GaussianRandomBatch.
+	constexpr int32 GaussianRandomChunkSize = 4096;
+
+	/**
+	 * Fills OutValues with normally distributed values of Mean and StandardDeviation, drawn with the ziggurat method.
+	 * Every chunk of GaussianRandomChunkSize values draws from its own stream derived from Seed, so the values only depend
+	 * on Seed and their index and are identical whether the chunks run on one thread or in ParallelFor.
+	 */
+	HYPHENUTIL_API void GaussianRandomBatch(int32 Seed, float Mean, float StandardDeviation, TArrayView<float> OutValues,
+	                                        EParallelForFlags Flags = EParallelForFlags::None);
+}
@@ -0,0 +1,99 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HyphenSpawnSubsystem.generated.h"
+
+USTRUCT(BlueprintType)
+struct FHyphenSpawnRequest
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSoftClassPtr<AActor> ActorClass;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FTransform Transform;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FHyphenActorSpawnDelegate, AActor*);
+
+/**
+ * Handle of a batch of actors spawned by UHyphenSpawnSubsystem.
+ * The subsystem keeps the batch alive until it completes, callers may keep the handle to watch progress or cancel.
+ */
+class HYPHENUTIL_API FHyphenSpawnBatch
+{
+public:
+	// Called after BeginDeferredActorSpawnFromClass, before the construction script and BeginPlay run.
+	FHyphenActorSpawnDelegate OnActorDeferredSpawn;
+	// Called after FinishSpawningActor.
+	FHyphenActorSpawnDelegate OnActorSpawned;
+	// Called once every request is spawned, failed or the batch is canceled.
+	FSimpleMulticastDelegate OnComplete;
+
+	int32 GetNumRequested() const { return Requests.Num(); }
+	int32 GetNumSpawned() const { return SpawnedActors.Num(); }
+	int32 GetNumFailed() const { return NumFailed; }
+	bool IsLoaded() const { return bLoaded; }
+	bool IsComplete() const { return bComplete; }
+	const TArray<TWeakObjectPtr<AActor>>& GetSpawnedActors() const { return SpawnedActors; }
+
+	// Stops spawning the remaining requests. Actors already spawned are kept.
+	void Cancel();
+
+private:
+	friend class UHyphenSpawnSubsystem;
+
+	TArray<FHyphenSpawnRequest> Requests;
+	TArray<TWeakObjectPtr<AActor>> SpawnedActors;
+	TSharedPtr<FStreamableHandle> LoadHandle;
+	TWeakObjectPtr<AActor> Owner;
+	ESpawnActorCollisionHandlingMethod CollisionHandling = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	int32 NextRequest = 0;
+	int32 NumFailed = 0;
+	bool bLoaded = false;
+	bool bComplete = false;
+
+	void Complete();
+};
+
+/**
+ * Spawns batches of actors from soft classes without hitches.
+ * Classes of a batch are loaded with one tagged async request, then actors are spawned deferred within SpawnBudgetMs per frame.
+ */
+UCLASS(config=Game)
+class HYPHENUTIL_API UHyphenSpawnSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UHyphenSpawnSubsystem* Get(const UObject* WorldContextObject);
+
+	/**
+	 * Loads the classes of Requests and spawns one actor per request over the next frames, in request order.
+	 * With a ReferenceAssetTag the classes are recorded under that tag and stay loaded until it is released,
+	 * otherwise they are kept only until the batch completes. An empty batch completes on the next tick.
+	 */
+	TSharedRef<FHyphenSpawnBatch> SpawnActorsAsync(const TArray<FHyphenSpawnRequest>& Requests, FName ReferenceAssetTag = NAME_None,
+	                                               TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority,
+	                                               AActor* Owner = nullptr,
+	                                               ESpawnActorCollisionHandlingMethod CollisionHandling = ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+private:
+	void OnBatchLoaded(TWeakPtr<FHyphenSpawnBatch> WeakBatch);
+	void SpawnNext(FHyphenSpawnBatch& Batch);
+
+	// Time spent spawning per frame, failed attempts included. At least one request is attempted each frame so batches always progress.
+	UPROPERTY(Config)
+	float SpawnBudgetMs = 2.f;
+
+	TArray<TSharedRef<FHyphenSpawnBatch>> Batches;
+};
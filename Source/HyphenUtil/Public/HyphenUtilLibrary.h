@@ -3,6 +3,8 @@
 #pragma once
 
 #include "GameplayTagContainer.h"
+#include "HyphenGameplayTagCache.h"
+#include "HyphenGameplayTagLiteral.h"
 #include "Components/PanelWidget.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Components/Widget.h"
@@ -81,6 +83,38 @@ public:
 	UFUNCTION(BlueprintPure, meta = (DisplayName = "Normal Distribution", Keywords = "Normal Distribution"), Category = "Math|Interpolation")
 	static float NormalDistribution(float Mean, float StandardDeviation, float Coefficient, float X);
 
+	/**
+	 * Calculates the normal distribution function for every input at once.
+	 *
+	 * Evaluated four samples at a time, use it for curves or influence maps with many samples. Without bFast the values match
+	 * NormalDistribution for each element up to the rounding of the exponent.
+	 *
+	 * @param Mean The mean (mu) of the normal distribution.
+	 * @param StandardDeviation The standard deviation (sigma) of the normal distribution.
+	 * @param Coefficient A coefficient to scale the output values.
+	 * @param X The input values.
+	 * @param bFast Uses an approximated exp with a relative error below HyphenUtil::NormalDistributionFastMaxRelativeError.
+	 *              Values below 2^-126 * Coefficient become 0.
+	 * @param OutValues The calculated values, in the order of X.
+	 */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Normal Distribution Array", Keywords = "Normal Distribution"), Category = "Math|Interpolation")
+	static void NormalDistributionArray(float Mean, float StandardDeviation, float Coefficient, const TArray<float>& X, bool bFast, TArray<float>& OutValues);
+
+	/**
+	 * Generates normally distributed random values.
+	 *
+	 * The values only depend on the seed and their index, the same seed always gives the same array. Useful for spread
+	 * patterns or procedural placement that have to be reproducible.
+	 *
+	 * @param Seed The seed of the random values.
+	 * @param Mean The mean (mu) of the normal distribution.
+	 * @param StandardDeviation The standard deviation (sigma) of the normal distribution.
+	 * @param Num The number of values to generate.
+	 * @param OutValues The generated values.
+	 */
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Gaussian Random Array", Keywords = "Normal Distribution Random"), Category = "Math|Random")
+	static void GaussianRandomArray(int32 Seed, float Mean, float StandardDeviation, int32 Num, TArray<float>& OutValues);
+
 	/**
 	 * Retrieves the reference count of an object, optionally returning the objects it refers to.
 	 * 
@@ -555,21 +589,105 @@ namespace HyphenUtil
 		}
 	}
 
+	namespace Private
+	{
+		// Appends Text to Builder without spaces, like FString::RemoveSpacesInline.
+		inline void AppendWithoutSpaces(FStringBuilderBase& Builder, FStringView Text)
+		{
+			for (const TCHAR Character : Text)
+			{
+				if (Character != TEXT(' '))
+				{
+					Builder.AppendChar(Character);
+				}
+			}
+		}
+
+		// Resolves a tag name without adding names that were never registered to the name table.
+		// Registered tags come from the lock free FGameplayTagIndex snapshot, the tag manager is only asked for the rest.
+		inline FGameplayTag RequestGameplayTag(FStringView TagName, bool bErrorIfNotFound)
+		{
+			const FName TagFName(TagName, FNAME_Find);
+			FGameplayTag Tag;
+			if (!TagFName.IsNone() && FGameplayTagIndex::Get().FindTag(TagFName, Tag))
+			{
+				return Tag;
+			}
+			if (TagFName.IsNone() && !bErrorIfNotFound)
+			{
+				return FGameplayTag();
+			}
+			// Unknown names only go through the tag manager to report the error
+			return FGameplayTag::RequestGameplayTag(TagFName.IsNone() ? FName(TagName) : TagFName, bErrorIfNotFound);
+		}
+	}
+
 	/**
 	 * Retrieves a gameplay tag from a string representation.
 	 *
 	 * This function converts a string into a FGameplayTag by removing any spaces and requesting the tag from the global
 	 * gameplay tag registry. It's useful for dynamically working with gameplay tags where the tag needs to be specified
-	 * by name at runtime.
+	 * by name at runtime. Spaces are stripped into a stack buffer, so no heap allocation is made. Registered tags are resolved
+	 * from the FGameplayTagIndex snapshot, which is safe from any thread.
 	 *
 	 * @param TagName The name of the tag to retrieve, spaces are ignored.
 	 * @return A FGameplayTag corresponding to the given string name. Returns an invalid tag if not found.
 	 */
-	static FGameplayTag GetGameplayTagFromString(const FString& TagName)
+	static FGameplayTag GetGameplayTagFromString(FStringView TagName)
 	{
-		FString CleanTagName = TagName;
-		CleanTagName.RemoveSpacesInline();
-		return FGameplayTag::RequestGameplayTag(*CleanTagName);
+		TStringBuilder<256> CleanTagName;
+		Private::AppendWithoutSpaces(CleanTagName, TagName);
+		return Private::RequestGameplayTag(CleanTagName.ToView(), true);
+	}
+
+	/**
+	 * Combines a parent tag name with a child name, both without spaces, through the tag index.
+	 *
+	 * Registered tags are found in FGameplayTagIndex without building the combined string, combinations resolved before
+	 * the index was built are kept in FGameplayTagCache. This is the cheapest way to combine tags. Safe to call from any thread.
+	 *
+	 * @param ParentTagName The parent tag name.
+	 * @param ChildName The child tag name, may contain several segments separated by dots.
+	 * @param bErrorIfNotFound Reports an error like FGameplayTag::RequestGameplayTag if the combined tag does not exist.
+	 * @return The combined gameplay tag, or an invalid tag if it does not exist.
+	 */
+	static FGameplayTag CombineGameplayTagWithName(FName ParentTagName, FName ChildName, bool bErrorIfNotFound = true)
+	{
+		FGameplayTag CombinedTag;
+		if (FGameplayTagIndex::Get().FindChild(ParentTagName, ChildName, CombinedTag) || FGameplayTagCache::Get().FindCombined(ParentTagName, ChildName, CombinedTag))
+		{
+			return CombinedTag;
+		}
+		TStringBuilder<256> CombinedName;
+		CombinedName << ParentTagName << TEXT('.') << ChildName;
+		CombinedTag = Private::RequestGameplayTag(CombinedName.ToView(), bErrorIfNotFound);
+		if (CombinedTag.IsValid())
+		{
+			FGameplayTagCache::Get().AddCombined(ParentTagName, ChildName, CombinedTag);
+		}
+		return CombinedTag;
+	}
+
+	namespace Private
+	{
+		// Combines names already stripped of spaces, through the index or the cache when the names exist in the name table.
+		inline FGameplayTag CombineCleanTagNames(FName ParentTagName, FStringView CleanParentTagName, FStringView CleanChildTagName, bool bErrorIfNotFound)
+		{
+			FGameplayTag CombinedTag;
+			if (!ParentTagName.IsNone() && FGameplayTagIndex::Get().FindChild(ParentTagName, CleanChildTagName, CombinedTag))
+			{
+				return CombinedTag;
+			}
+			const FName ChildName(CleanChildTagName, FNAME_Find);
+			if (!ParentTagName.IsNone() && !ChildName.IsNone())
+			{
+				return CombineGameplayTagWithName(ParentTagName, ChildName, bErrorIfNotFound);
+			}
+			// A child of several segments may have no name of its own, resolve the full name instead
+			TStringBuilder<256> CombinedName;
+			CombinedName << CleanParentTagName << TEXT('.') << CleanChildTagName;
+			return RequestGameplayTag(CombinedName.ToView(), bErrorIfNotFound);
+		}
 	}
 
 	/**
@@ -582,15 +700,14 @@ namespace HyphenUtil
 	 * @param ChildTag The child tag name to combine with the parent tag.
 	 * @return A new FGameplayTag that represents the combination of the parent and child tag names.
 	 */
-	static FGameplayTag CombineGameplayTagWithString(const FString& Tag, const FString& ChildTag)
+	static FGameplayTag CombineGameplayTagWithString(FStringView Tag, FStringView ChildTag)
 	{
 		// Remove spaces from the tag name
-		FString CleanTagName = Tag;
-		CleanTagName.RemoveSpacesInline();
-		FString CleanChildTagName = ChildTag;
-		CleanChildTagName.RemoveSpacesInline();
-		const FString& CombinedString = FString::Printf(TEXT("%s.%s"), *CleanTagName, *CleanChildTagName);
-		return FGameplayTag::RequestGameplayTag(*CombinedString);
+		TStringBuilder<256> CleanTagName;
+		Private::AppendWithoutSpaces(CleanTagName, Tag);
+		TStringBuilder<128> CleanChildTagName;
+		Private::AppendWithoutSpaces(CleanChildTagName, ChildTag);
+		return Private::CombineCleanTagNames(FName(CleanTagName.ToView(), FNAME_Find), CleanTagName.ToView(), CleanChildTagName.ToView(), true);
 	}
 
 	/**
@@ -604,10 +721,24 @@ namespace HyphenUtil
 	 * @param ChildTag The child tag name to combine with the parent tag.
 	 * @return A new FGameplayTag that represents the combination of the parent tag and the child tag name.
 	 */
-	static FGameplayTag CombineGameplayTagWithString(const FGameplayTag& Tag, const FString& ChildTag)
+	static FGameplayTag CombineGameplayTagWithString(const FGameplayTag& Tag, FStringView ChildTag)
 	{
 		// Remove spaces from the tag name
-		return CombineGameplayTagWithString(Tag.ToString(), ChildTag);
+		TStringBuilder<128> CleanChildTagName;
+		Private::AppendWithoutSpaces(CleanChildTagName, ChildTag);
+		FGameplayTag CombinedTag;
+		if (FGameplayTagIndex::Get().FindChild(Tag.GetTagName(), CleanChildTagName.ToView(), CombinedTag))
+		{
+			return CombinedTag;
+		}
+		const FName ChildName(CleanChildTagName.ToView(), FNAME_Find);
+		if (!ChildName.IsNone())
+		{
+			return CombineGameplayTagWithName(Tag.GetTagName(), ChildName);
+		}
+		TStringBuilder<256> ParentTagName;
+		ParentTagName << Tag.GetTagName();
+		return Private::CombineCleanTagNames(Tag.GetTagName(), ParentTagName.ToView(), CleanChildTagName.ToView(), true);
 	}
 
 	/**
@@ -622,17 +753,32 @@ namespace HyphenUtil
 	 * @param OutTag Reference to the resulting gameplay tag if successful.
 	 * @return true if the combination results in a valid gameplay tag, false otherwise.
 	 */
-	static bool TryCombineGameplayTagWithString(const FString& Tag, const FString& ChildTag, FGameplayTag& OutTag)
+	static bool TryCombineGameplayTagWithString(FStringView Tag, FStringView ChildTag, FGameplayTag& OutTag)
 	{
 		// Remove spaces from the tag name
-		FString CleanTagName = Tag;
-		CleanTagName.RemoveSpacesInline();
-		FString CleanChildTagName = ChildTag;
-		CleanChildTagName.RemoveSpacesInline();
-		const FString& CombinedString = FString::Printf(TEXT("%s.%s"), *CleanTagName, *CleanChildTagName);
-		if(FGameplayTag::IsValidGameplayTagString(CombinedString))
-		{
-			OutTag = FGameplayTag::RequestGameplayTag(*CombinedString, false);
+		TStringBuilder<256> CleanTagName;
+		Private::AppendWithoutSpaces(CleanTagName, Tag);
+		TStringBuilder<128> CleanChildTagName;
+		Private::AppendWithoutSpaces(CleanChildTagName, ChildTag);
+		const FName ParentTagName(CleanTagName.ToView(), FNAME_Find);
+		if(!ParentTagName.IsNone() && FGameplayTagIndex::Get().FindChild(ParentTagName, CleanChildTagName.ToView(), OutTag))
+		{
+			return true;
+		}
+		const FName ChildName(CleanChildTagName.ToView(), FNAME_Find);
+		if(!ParentTagName.IsNone() && !ChildName.IsNone() && FGameplayTagCache::Get().FindCombined(ParentTagName, ChildName, OutTag))
+		{
+			return true;
+		}
+		TStringBuilder<256> CombinedName;
+		CombinedName << CleanTagName << TEXT('.') << CleanChildTagName;
+		if(FGameplayTag::IsValidGameplayTagString(FString(CombinedName.ToView())))
+		{
+			OutTag = Private::RequestGameplayTag(CombinedName.ToView(), false);
+			if(OutTag.IsValid() && !ParentTagName.IsNone() && !ChildName.IsNone())
+			{
+				FGameplayTagCache::Get().AddCombined(ParentTagName, ChildName, OutTag);
+			}
 			return true;
 		}
 		else
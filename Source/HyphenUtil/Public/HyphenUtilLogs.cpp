@@ -1,3 +1,6 @@
 ﻿#include "HyphenUtilLogs.h"
 
 DEFINE_LOG_CATEGORY(LogHyphenUtil);
+
+LLM_DEFINE_TAG(HyphenUtil);
+LLM_DEFINE_TAG(HyphenUtil_AssetManager, TEXT("AssetManager"), TEXT("HyphenUtil"));
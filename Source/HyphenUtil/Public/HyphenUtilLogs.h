@@ -1,3 +1,9 @@
 ﻿#pragma once
 
-HYPHENUTIL_API DECLARE_LOG_CATEGORY_EXTERN(LogHyphenUtil, Log, All);
\ No newline at end of file
+#include "HAL/LowLevelMemTracker.h"
+
+HYPHENUTIL_API DECLARE_LOG_CATEGORY_EXTERN(LogHyphenUtil, Log, All);
+
+// Low-level memory tracker tags, shown as HyphenUtil and HyphenUtil/AssetManager in memreport and Insights.
+LLM_DECLARE_TAG_API(HyphenUtil, HYPHENUTIL_API);
+LLM_DECLARE_TAG_API(HyphenUtil_AssetManager, HYPHENUTIL_API);
\ No newline at end of file
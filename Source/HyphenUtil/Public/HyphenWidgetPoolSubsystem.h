@@ -0,0 +1,120 @@
+// Copyright Hyphen Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/Interface.h"
+#include "HyphenWidgetPoolSubsystem.generated.h"
+
+UINTERFACE(BlueprintType)
+class HYPHENUTIL_API UHyphenPoolableWidget : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Pooled widgets are constructed once and keep their Slate widgets between uses.
+ * State of the previous use has to be reset in OnPoolReleased.
+ */
+class HYPHENUTIL_API IHyphenPoolableWidget
+{
+	GENERATED_BODY()
+
+public:
+	// Called after the widget is taken from the pool, before it is added to a parent.
+	UFUNCTION(BlueprintNativeEvent, Category = "HyphenUtil|WidgetPool")
+	void OnPoolAcquired();
+	// Called after the widget is removed from its parent and returned to the pool.
+	UFUNCTION(BlueprintNativeEvent, Category = "HyphenUtil|WidgetPool")
+	void OnPoolReleased();
+};
+
+USTRUCT()
+struct FHyphenWidgetFreeList
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TArray<TObjectPtr<UUserWidget>> Widgets;
+	// Reference tag the class was loaded with, the free list is drained when the tag is released.
+	FName ReferenceAssetTag;
+};
+
+/**
+ * Reuses user widgets per class instead of creating them for every screen.
+ * Prewarmed widgets are created within PrewarmBudgetMs per frame.
+ */
+UCLASS(config=Game)
+class HYPHENUTIL_API UHyphenWidgetPoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UHyphenWidgetPoolSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Takes a pooled widget of WidgetClass, or creates one if the pool is empty.
+	UFUNCTION(BlueprintCallable, Category = "HyphenUtil|WidgetPool", meta = (DeterminesOutputType = "WidgetClass"))
+	UUserWidget* AcquireWidget(TSubclassOf<UUserWidget> WidgetClass, APlayerController* OwningPlayer = nullptr);
+	template <typename WidgetType>
+	WidgetType* AcquireWidget(APlayerController* OwningPlayer = nullptr)
+	{
+		return Cast<WidgetType>(AcquireWidget(WidgetType::StaticClass(), OwningPlayer));
+	}
+
+	// Removes the widget from its parent and returns it to the pool of its class.
+	UFUNCTION(BlueprintCallable, Category = "HyphenUtil|WidgetPool")
+	void ReleaseWidget(UUserWidget* Widget);
+
+	/**
+	 * Loads WidgetClass under ReferenceAssetTag and creates Count pooled widgets over the next frames.
+	 * The pool of the class is drained once the tag is released.
+	 */
+	void PrewarmWidgets(const TSoftClassPtr<UUserWidget>& WidgetClass, int32 Count, FName ReferenceAssetTag);
+
+	// Drops every pooled widget of WidgetClass.
+	void DrainPool(TSubclassOf<UUserWidget> WidgetClass);
+	int32 GetNumPooledWidgets(TSubclassOf<UUserWidget> WidgetClass) const;
+
+	/**
+	 * Same result as UHyphenUtilLibrary::GetWidgetsFromWidgetTree, but the scan is cached per widget and class,
+	 * so reused widgets do not walk their tree again. Trees that add or remove children at runtime should not use this.
+	 * The returned array is valid until the next call.
+	 */
+	const TArray<UWidget*>& GetCachedWidgetsFromWidgetTree(UUserWidget* Widget, TSubclassOf<UWidget> WidgetClass);
+
+private:
+	struct FPendingPrewarm
+	{
+		TSoftClassPtr<UUserWidget> WidgetClass;
+		FName ReferenceAssetTag;
+		int32 Remaining = 0;
+		bool bLoaded = false;
+	};
+
+	FHyphenWidgetFreeList& FindOrAddFreeList(TSubclassOf<UUserWidget> WidgetClass, FName ReferenceAssetTag);
+	void OnReferenceTagReleased(FName ReferenceAssetTag);
+
+	// Pooled widgets kept per class, extra released widgets are left to GC.
+	UPROPERTY(Config)
+	int32 MaxPooledWidgetsPerClass = 128;
+	// Time spent creating prewarmed widgets per frame.
+	UPROPERTY(Config)
+	float PrewarmBudgetMs = 2.f;
+
+	UPROPERTY()
+	TMap<TSubclassOf<UUserWidget>, FHyphenWidgetFreeList> FreeLists;
+	TArray<TSharedRef<FPendingPrewarm>> PendingPrewarms;
+	// Weak, the cache must neither keep widgets alive nor hand out ones GC already collected.
+	TMap<TObjectKey<UUserWidget>, TMap<TObjectKey<UClass>, TArray<TWeakObjectPtr<UWidget>>>> WidgetTreeCache;
+	// Resolved widgets of the last GetCachedWidgetsFromWidgetTree call.
+	TArray<UWidget*> CachedWidgetsResult;
+	FDelegateHandle ReferenceTagReleasedHandle;
+};